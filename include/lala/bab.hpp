@@ -3,6 +3,8 @@
 #ifndef LALA_POWER_BAB_HPP
 #define LALA_POWER_BAB_HPP
 
+#include <type_traits>
+
 #include "battery/vector.hpp"
 #include "battery/shared_ptr.hpp"
 #include "lala/logic/logic.hpp"
@@ -76,21 +78,57 @@ public:
   template <class Alloc2>
   using ask_type = typename sub_type::template ask_type<Alloc2>;
 
+private:
+  using local_universe = typename sub_type::universe_type::local_type;
+  using sub_tell_type = typename sub_type::template tell_type<allocator_type>;
+
+  /** \return the tells on the variables in `t`, which is `t` itself for a store, and the tell of its sub-domain for a search tree. */
+  template <class T>
+  CUDA static auto& var_tells(T& t) {
+    if constexpr(requires { t.sub_tell; }) {
+      return t.sub_tell;
+    }
+    else {
+      return t;
+    }
+  }
+
+public:
+  /** `true` if the bound of the objective is directly added to the sub-domain as a tell `(x, u)` in the universe of the variable.
+   * It requires the tells on the variables of the sub-domain to be a vector of elements constructible from `(AVar, local_universe)` (e.g., `VStore`, or a search tree over a `VStore`), and the universe to be over integers.
+   * Otherwise, the bound is deinterpreted to a formula `x < k` (or `x > k`) which is interpreted in the sub-domain. */
+  constexpr static const bool direct_bound =
+    std::is_integral_v<typename local_universe::value_type> &&
+    requires(AVar x, local_universe u, sub_tell_type t) {
+      var_tells(t).push_back(typename std::remove_reference_t<decltype(var_tells(t))>::value_type(x, u));
+    };
+
   template <class A2, class B2>
   friend class BAB;
 
 private:
+  struct objective_type {
+    AVar x;
+    bool minimize; // `true` for minimization, `false` for maximization.
+  };
+
   AType atype;
   sub_ptr sub;
   best_ptr best;
-  AVar x;
-  bool optimization_mode; // `true` for minimization, `false` for maximization.
+  // The objectives in lexicographic order, empty in satisfaction problems.
+  battery::vector<objective_type, allocator_type> objectives;
   int solutions_found;
+  // `false` when the lexicographic ordering of several objectives could not be deduced in the sub-domain (see `deduce_best_bound`).
+  bool lex_bound;
+  // The lexicographic ordering interpreted in the sub-domain, and the values of the objectives in `best` it was interpreted for.
+  typename sub_type::template tell_type<allocator_type> lex_tell;
+  battery::vector<typename best_type::universe_type, allocator_type> lex_values;
 
 public:
   CUDA BAB(AType atype, sub_ptr sub, best_ptr best)
-   : atype(atype), sub(std::move(sub)), best(std::move(best)), x(),
-     solutions_found(0)
+   : atype(atype), sub(std::move(sub)), best(std::move(best)),
+     objectives(this->sub->get_allocator()), solutions_found(0), lex_bound(true),
+     lex_values(this->sub->get_allocator())
   {
     assert(this->sub);
     assert(this->best);
@@ -105,9 +143,14 @@ public:
   CUDA NI BAB(const BAB<A2, B2>& other, AbstractDeps<Allocators...>& deps)
    : atype(other.atype)
    , sub(deps.template clone<sub_type>(other.sub))
-   , x(other.x)
-   , optimization_mode(other.optimization_mode)
+   , objectives(deps.template get_allocator<allocator_type>())
+   , solutions_found(other.solutions_found)
+   , lex_bound(other.lex_bound)
+   , lex_values(deps.template get_allocator<allocator_type>())
   {
+    for(int i = 0; i < other.objectives.size(); ++i) {
+      objectives.push_back(objective_type{other.objectives[i].x, other.objectives[i].minimize});
+    }
     AbstractDeps<Allocators...> deps_best(false, deps.template get_allocator<Allocators>()...);
     best = deps_best.template clone<best_type>(other.best);
   }
@@ -125,7 +168,7 @@ public:
   }
 
   CUDA local::B is_top() const {
-    return x.is_untyped() && sub->is_top();
+    return objectives.empty() && sub->is_top();
   }
 
 public:
@@ -173,88 +216,281 @@ public:
     }
   }
 
+  /** Add the objective of `t`, if any, after the objectives already added: several objectives are optimized in lexicographic order. */
   template <class Alloc>
   CUDA bool deduce(const tell_type<Alloc>& t) {
     bool has_changed = sub->deduce(t.sub_tell);
     if(!t.x.is_untyped()) {
-      assert(x.is_untyped()); // multi-objective optimization not yet supported.
-      x = t.x;
-      optimization_mode = t.optimization_mode;
+      objectives.push_back(objective_type{t.x, t.optimization_mode});
       return true;
     }
     return has_changed;
   }
 
+private:
+  /** \return the formula `x_i < k` (`x_i <= k` if not `strict`) when minimizing the objective `i`, and `x_i > k` (`x_i >= k`) when maximizing it, where `k` is the bound of `best_bound`. */
   template <class Alloc2>
-  CUDA NI TFormula<Alloc2> deinterpret_best_bound(const typename best_type::universe_type& best_bound, const Alloc2& alloc = Alloc2{}) const {
+  CUDA NI TFormula<Alloc2> deinterpret_bound(int i, const typename best_type::universe_type& best_bound, bool strict, const Alloc2& alloc) const {
     using F = TFormula<Alloc2>;
-    if((is_minimization() && best_bound.lb().is_top())
-      ||(is_maximization() && best_bound.ub().is_top()))
+    bool minimize = objectives[i].minimize;
+    if((minimize && best_bound.lb().is_top())
+      ||(!minimize && best_bound.ub().is_top()))
     {
       return F::make_true();
     }
-    Sig optimize_sig = is_minimization() ? LT : GT;
-    F constant = is_minimization()
+    Sig optimize_sig = minimize ? (strict ? LT : LEQ) : (strict ? GT : GEQ);
+    F constant = minimize
       ? best_bound.lb().template deinterpret<F>()
       : best_bound.ub().template deinterpret<F>();
-    return F::make_binary(F::make_avar(x), optimize_sig, constant, UNTYPED, alloc);
+    return F::make_binary(F::make_avar(objectives[i].x), optimize_sig, constant, UNTYPED, alloc);
+  }
+
+public:
+  template <class Alloc2>
+  CUDA NI TFormula<Alloc2> deinterpret_best_bound(const typename best_type::universe_type& best_bound, const Alloc2& alloc = Alloc2{}) const {
+    return deinterpret_bound(0, best_bound, true, alloc);
   }
 
+  /** \return the formula satisfied by the solutions better than `best`, i.e., `x_1 < v_1 \/ (x_1 = v_1 /\ (x_2 < v_2 \/ (x_2 = v_2 /\ ...)))` when minimizing the objectives `x_1, ..., x_n` of values `v_1, ..., v_n` in `best`. */
   template <class Alloc2>
-  CUDA TFormula<Alloc2> deinterpret_best_bound(const Alloc2& alloc = Alloc2{}) const {
-    return deinterpret_best_bound(best->project(x), alloc);
+  CUDA NI TFormula<Alloc2> deinterpret_best_bound(const Alloc2& alloc = Alloc2{}) const {
+    using F = TFormula<Alloc2>;
+    assert(is_optimization());
+    int n = objectives.size();
+    F f = deinterpret_bound(n - 1, best->project(objectives[n - 1].x), true, alloc);
+    for(int i = n - 2; i >= 0; --i) {
+      auto bound = best->project(objectives[i].x);
+      // If the objective is not assigned in `best`, we only require the next solutions to be as good on this objective.
+      if(bound.lb().is_top() || bound.ub().is_top() || bound.lb().value() != bound.ub().value()) {
+        f = deinterpret_bound(i, bound, false, alloc);
+      }
+      else {
+        F equal = F::make_binary(F::make_avar(objectives[i].x), EQ, bound.lb().template deinterpret<F>(), UNTYPED, alloc);
+        f = F::make_binary(
+          deinterpret_bound(i, bound, true, alloc),
+          OR,
+          F::make_binary(std::move(equal), AND, std::move(f), UNTYPED, alloc),
+          UNTYPED, alloc);
+      }
+    }
+    return f;
   }
 
-  /** Update the variable to optimize `objective_var()` with a new bound. */
+  /** Update the first objective `objective_var()` with a new bound.
+   * With a single objective, the next solutions must be strictly better than `best_bound`.
+   * With several objectives, they must only be at least as good as `best_bound` on the first objective, since a solution equal on the first objective can still improve the next ones (the lexicographic ordering is added by `deduce()`).
+   * Hence, a bound shared between several `BAB` (e.g., by `SharedBoundClient`) prunes strictly only when there is a single objective. */
   CUDA local::B deduce(const typename best_type::universe_type& best_bound) {
-    VarEnv<allocator_type> empty_env{};
-    using F = TFormula<allocator_type>;
-    F bound_formula = deinterpret_best_bound(best_bound, get_allocator());
-    IDiagnostics diagnostics;
-    typename sub_type::template tell_type<allocator_type> t;
-    bool res = sub->interpret_tell(bound_formula, empty_env, t, diagnostics);
-    assert(res);
+    return deduce_bound(best_bound, objectives.size() == 1);
+  }
+
+private:
+  CUDA local::B deduce_bound(const typename best_type::universe_type& best_bound, bool strict) {
+    if constexpr(direct_bound) {
+      return deduce_direct_bound(best_bound, strict);
+    }
+    else {
+      VarEnv<allocator_type> empty_env{};
+      using F = TFormula<allocator_type>;
+      F bound_formula = deinterpret_bound(0, best_bound, strict, get_allocator());
+      IDiagnostics diagnostics;
+      typename sub_type::template tell_type<allocator_type> t;
+      bool res = sub->interpret_tell(bound_formula, empty_env, t, diagnostics);
+      assert(res);
+      return sub->deduce(t);
+    }
+  }
+
+  /** Meet `x < lb(best_bound)` (or `x > ub(best_bound)`, and `x <= lb(best_bound)` or `x >= ub(best_bound)` if not `strict`) in the sub-domain without going through the interpretation of a formula (see `direct_bound`).
+   * When no value is strictly better than the bound, the sub-domain becomes `bot`. */
+  CUDA local::B deduce_direct_bound(const typename best_type::universe_type& best_bound, bool strict) {
+    using value_type = typename local_universe::value_type;
+    bool minimize = is_minimization(0);
+    if((minimize && best_bound.lb().is_top()) || (!minimize && best_bound.ub().is_top())) {
+      return false;
+    }
+    local_universe u = local_universe::top();
+    if(minimize) {
+      value_type v = best_bound.lb().value();
+      if(strict && v <= battery::limits<value_type>::neg_inf()) {
+        u = local_universe::bot();
+      }
+      else {
+        u.meet_ub(typename local_universe::UB(strict ? v - 1 : v));
+      }
+    }
+    else {
+      value_type v = best_bound.ub().value();
+      if(strict && v >= battery::limits<value_type>::inf()) {
+        u = local_universe::bot();
+      }
+      else {
+        u.meet_lb(typename local_universe::LB(strict ? v + 1 : v));
+      }
+    }
+    sub_tell_type t(get_allocator());
+    using var_tell_type = typename std::remove_reference_t<decltype(var_tells(t))>::value_type;
+    var_tells(t).push_back(var_tell_type(objectives[0].x, u));
     return sub->deduce(t);
   }
 
-  /** Compare the best bound of two stores on the objective variable represented in this BAB abstract element.
+  /** Require the next solutions to be better than `best`.
+   * With several objectives, the bound of the first objective is added directly, and the lexicographic ordering (`deinterpret_best_bound()`) is added if the sub-domain can interpret it (it requires disjunctions).
+   * Otherwise, only the bound of the first objective prunes the search tree, and `deduce()` rejects the solutions that are not better than `best`.
+   * The lexicographic ordering is interpreted once per objective vector (not again when `resume` restores the same `best`, e.g., on each neighbourhood of `LNS`), and never again once the sub-domain rejected it. */
+  CUDA local::B deduce_best_bound() {
+    local::B has_changed = deduce(best->project(objectives[0].x));
+    // Whether the sub-domain can interpret the lexicographic ordering only depends on the shape of the formula, hence it is not interpreted again on the next solutions once it was rejected.
+    if(objectives.size() > 1 && lex_bound) {
+      if(!is_lex_tell_current()) {
+        VarEnv<allocator_type> empty_env{};
+        IDiagnostics diagnostics;
+        typename sub_type::template tell_type<allocator_type> t;
+        lex_bound = sub->interpret_tell(deinterpret_best_bound(get_allocator()), empty_env, t, diagnostics);
+        if(!lex_bound) {
+          return has_changed;
+        }
+        lex_tell = std::move(t);
+        lex_values.clear();
+        for(int i = 0; i < objectives.size(); ++i) {
+          lex_values.push_back(best->project(objectives[i].x));
+        }
+      }
+      has_changed |= sub->deduce(lex_tell);
+    }
+    return has_changed;
+  }
+
+  /** \return `true` if `lex_tell` was interpreted for the current values of the objectives in `best` (e.g., when `resume` is called again without new solution). */
+  CUDA bool is_lex_tell_current() const {
+    if(lex_values.size() != objectives.size()) {
+      return false;
+    }
+    for(int i = 0; i < objectives.size(); ++i) {
+      if(lex_values[i] != best->project(objectives[i].x)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** \return `1` if `bound1` is strictly better than `bound2` on the objective `i`, `-1` if it is strictly worse, and `0` otherwise. */
+  template <class Univ1, class Univ2>
+  CUDA int compare_objective_bounds(int i, const Univ1& bound1, const Univ2& bound2) const {
+    if(!bound1.is_top() && bound2.is_top()) {
+      return 1;
+    }
+    else if(bound1.is_top() && !bound2.is_top()) {
+      return -1;
+    }
+    // When minimizing, the best bound is getting smaller and smaller.
+    if(objectives[i].minimize) {
+      return bound1.lb() > bound2.lb() ? 1 : (bound2.lb() > bound1.lb() ? -1 : 0); // note that `>` reflects the order of LB.
+    }
+    // And dually for maximization.
+    else {
+      return bound1.ub() > bound2.ub() ? 1 : (bound2.ub() > bound1.ub() ? -1 : 0);
+    }
+  }
+
+  /** Extract the current solution of the sub-domain in `best` if it is strictly better than `best` in the lexicographic order.
+   * \return `false` if the solution was rejected, in which case `best` is unchanged. */
+  CUDA bool extract_if_better() {
+    using best_universe = typename best_type::local_universe;
+    battery::vector<best_universe, allocator_type> previous(get_allocator());
+    for(int i = 0; i < objectives.size(); ++i) {
+      previous.push_back(best->project(objectives[i].x));
+    }
+    auto snap = best->snapshot(get_allocator());
+    sub->extract(*best);
+    for(int i = 0; i < objectives.size(); ++i) {
+      int c = compare_objective_bounds(i, best->project(objectives[i].x), previous[i]);
+      if(c > 0) {
+        return true;
+      }
+      else if(c < 0) {
+        break;
+      }
+    }
+    best->restore(snap);
+    return false;
+  }
+
+  /** \return `1` if `store1` is strictly better than `store2` on the objective `i`, `-1` if it is strictly worse, and `0` otherwise. */
+  template <class Store1, class Store2>
+  CUDA int compare_objective(int i, const Store1& store1, const Store2& store2) const {
+    using Univ1 = typename Store1::local_universe;
+    using Univ2 = typename Store2::local_universe;
+    Univ1 bound1 = store1.project(objectives[i].x);
+    Univ2 bound2 = store2.project(objectives[i].x);
+    return compare_objective_bounds(i, bound1, bound2);
+  }
+
+public:
+  /** Compare the best bound of two stores on the objective variables represented in this BAB abstract element, in lexicographic order.
    * \pre `is_optimization()` must be `true`.
    * \return `true` if `store1` is strictly better than `store2`, false otherwise.
   */
   template <class Store1, class Store2>
   CUDA bool compare_bound(const Store1& store1, const Store2& store2) const {
     assert(is_optimization());
-    using Univ1 = typename Store1::local_universe;
-    using Univ2 = typename Store2::local_universe;
-    Univ1 bound1 = store1.project(x);
-    Univ2 bound2 = store2.project(x);
-    // When minimizing, the best bound is getting smaller and smaller.
-    if(is_minimization()) {
-      return (!bound1.is_top() && bound2.is_top()) || bound1.lb() > bound2.lb(); // note that `>` reflects the order of LB.
-    }
-    // And dually for maximization.
-    else {
-      return (!bound1.is_top() && bound2.is_top()) || bound1.ub() > bound2.ub();
+    for(int i = 0; i < objectives.size(); ++i) {
+      int c = compare_objective(i, store1, store2);
+      if(c != 0) {
+        return c > 0;
+      }
     }
+    return false;
   }
 
   /** This deduction operator performs "branch-and-bound" by adding a constraint to the root node of the search tree to ensure the next solution is better than the current one, and store the best solution found.
-   * \pre The current subelement must be extractable, and if it is an optimization problem, have a better bound than `best` (this is not checked here).
+   * If the split strategy of the sub-domain supports it, the best solution is also saved for solution-guided search (see `ValueOrder::SOLUTION`).
+   * \pre The current subelement must be extractable, and if it is an optimization problem, have a better bound than `best`.
+   * This is only checked when the sub-domain could not deduce the lexicographic ordering of several objectives (see `is_lexicographic_bound_deduced`), in which case the solutions that are not better than `best` are rejected and we return `false`.
    * Beware this deduction operator is not idempotent (it must only be called once on each new solution).
    */
   CUDA local::B deduce() {
-    sub->extract(*best);
+    if(!lex_bound && solutions_found > 0) {
+      if(!extract_if_better()) {
+        return false;
+      }
+    }
+    else {
+      sub->extract(*best);
+    }
     solutions_found++;
+    if constexpr(requires { sub->statistics().record_solution(); }) {
+      sub->statistics().record_solution();
+    }
+    if constexpr(requires { sub->split->save_phase(*best); }) {
+      sub->split->save_phase(*best);
+    }
     if(is_optimization()) {
-      deduce(best->project(x));
+      deduce_best_bound();
     }
     return true;
   }
 
+  /** \return `false` if there are several objectives and the sub-domain could not interpret the lexicographic ordering of the objectives (it requires disjunctions).
+   * The next solutions are then only required to be as good as `best` on the first objective, and `deduce()` checks that they are better than `best`. */
+  CUDA bool is_lexicographic_bound_deduced() const {
+    return lex_bound;
+  }
+
   CUDA int solutions_count() const {
     return solutions_found;
   }
 
+  /** Resume the optimization when `best` was restored from a previous search (e.g., from a checkpoint) in which `num_solutions` solutions were found.
+   * The bound of `best` is added to the search tree. */
+  CUDA local::B resume(int num_solutions) {
+    solutions_found = num_solutions;
+    if(solutions_found > 0 && is_optimization()) {
+      return deduce_best_bound();
+    }
+    return false;
+  }
+
   /** Given an optimization problem, it is extractable only when we have explored the whole state space (indicated by the subdomain being equal to top), we have found one solution, and that solution is extractable. */
   template <class ExtractionStrategy = NonAtomicExtraction>
   CUDA bool is_extractable(const ExtractionStrategy& strategy = ExtractionStrategy()) const {
@@ -268,8 +504,11 @@ public:
     if constexpr(impl::is_bab_like<AbstractBest>::value) {
       best->extract(*(ua.best));
       ua.solutions_found = solutions_found;
-      ua.x = x;
-      ua.optimization_mode = optimization_mode;
+      ua.lex_bound = lex_bound;
+      ua.objectives.clear();
+      for(int i = 0; i < objectives.size(); ++i) {
+        ua.objectives.push_back(typename AbstractBest::objective_type{objectives[i].x, objectives[i].minimize});
+      }
     }
     else {
       return best->extract(ua);
@@ -287,23 +526,33 @@ public:
   }
 
   CUDA bool is_satisfaction() const {
-    return x.is_untyped();
+    return objectives.empty();
   }
 
   CUDA bool is_optimization() const {
     return !is_satisfaction();
   }
 
+  /** \return `true` if the first objective is minimized. */
   CUDA bool is_minimization() const {
-    return is_optimization() && optimization_mode;
+    return is_optimization() && objectives[0].minimize;
   }
 
   CUDA bool is_maximization() const {
-    return is_optimization() && !optimization_mode;
+    return is_optimization() && !objectives[0].minimize;
+  }
+
+  /** \return the `i`-th objective variable in the lexicographic order, or an untyped variable if there is no such objective. */
+  CUDA AVar objective_var(int i = 0) const {
+    return i < objectives.size() ? objectives[i].x : AVar{};
+  }
+
+  CUDA bool is_minimization(int i) const {
+    return objectives[i].minimize;
   }
 
-  CUDA AVar objective_var() const {
-    return x;
+  CUDA int num_objectives() const {
+    return objectives.size();
   }
 };
 
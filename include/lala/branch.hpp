@@ -3,11 +3,21 @@
 #ifndef LALA_POWER_BRANCH_HPP
 #define LALA_POWER_BRANCH_HPP
 
+#include <cstdint>
+
 #include "battery/vector.hpp"
 #include "lala/logic/logic.hpp"
 
 namespace lala {
 
+/** The decision of a branch on an integer variable `x`, of which the children are `x left_op value` and `x right_op value`.
+ * It is enough to build the branch again without the variable and value orders (see `SplitStrategy::branch_of`), for instance when resuming a search from a checkpoint. */
+struct BranchDecision {
+  Sig left_op;
+  Sig right_op;
+  int64_t value;
+};
+
 template <class TellTy, class Alloc>
 class Branch {
 public:
@@ -20,17 +30,26 @@ public:
 private:
   battery::vector<tell_type, allocator_type> children;
   int current_idx;
+  AVar x;
+  bool has_dec;
+  BranchDecision dec;
 
 public:
-  CUDA Branch(const allocator_type& alloc = allocator_type()): children(alloc), current_idx(-1) {}
+  CUDA Branch(const allocator_type& alloc = allocator_type()): children(alloc), current_idx(-1), has_dec(false), dec{} {}
   Branch(const Branch&) = default;
   Branch(Branch&&) = default;
-  CUDA Branch(battery::vector<tell_type, allocator_type>&& children)
-   : children(std::move(children)), current_idx(-1) {}
+
+  /** `x` is the variable split by this branch, if any. */
+  CUDA Branch(battery::vector<tell_type, allocator_type>&& children, AVar x = AVar{})
+   : children(std::move(children)), current_idx(-1), x(x), has_dec(false), dec{} {}
+
+  /** The children of the branch are the interpretation of `x decision.left_op decision.value` and `x decision.right_op decision.value`. */
+  CUDA Branch(battery::vector<tell_type, allocator_type>&& children, AVar x, const BranchDecision& decision)
+   : children(std::move(children)), current_idx(-1), x(x), has_dec(true), dec(decision) {}
 
   template <class BranchType>
   CUDA Branch(const BranchType& branch, const allocator_type& alloc = allocator_type())
-   : children(branch.children, alloc), current_idx(branch.current_idx) {}
+   : children(branch.children, alloc), current_idx(branch.current_idx), x(branch.x), has_dec(branch.has_dec), dec(branch.dec) {}
 
   CUDA int size() const {
     return static_cast<int>(children.size()/*size_t*/);
@@ -49,6 +68,15 @@ public:
     return current_idx + 1 < size();
   }
 
+  /** Remove the last unexplored child from this branch and return it.
+   * It is used to give away a part of the search tree, for instance to another worker in parallel search. */
+  CUDA tell_type steal() {
+    assert(has_next());
+    tell_type child(std::move(children.back()));
+    children.pop_back();
+    return child;
+  }
+
   CUDA void prune() {
     current_idx = size();
   }
@@ -57,6 +85,28 @@ public:
     return current_idx >= size();
   }
 
+  /** \return the index of the child currently explored, or `-1` if none was explored yet.
+   * The index is also the number of discrepancies (i.e., the number of times we did not follow the heuristic) taken at this branch. */
+  CUDA int current_index() const {
+    return current_idx;
+  }
+
+  /** \return the variable split by this branch, it is untyped if the branch was not created by splitting a single variable. */
+  CUDA AVar var() const {
+    return x;
+  }
+
+  /** \return `true` if the decision of this branch is known (see `decision()`), which is the case of the branches built by `SplitStrategy` on integer variables. */
+  CUDA bool has_decision() const {
+    return has_dec;
+  }
+
+  /** \pre `has_decision()` must be `true`. */
+  CUDA const BranchDecision& decision() const {
+    assert(has_dec);
+    return dec;
+  }
+
   CUDA const tell_type& current() const {
     assert(current_idx != -1 && current_idx < children.size());
     return children[current_idx];
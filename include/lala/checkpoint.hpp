@@ -0,0 +1,265 @@
+// Copyright 2025 Pierre Talbot
+
+#ifndef LALA_POWER_CHECKPOINT_HPP
+#define LALA_POWER_CHECKPOINT_HPP
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+#include "battery/vector.hpp"
+#include "search_tree.hpp"
+#include "bab.hpp"
+
+namespace lala {
+
+namespace impl {
+  constexpr static const uint32_t checkpoint_magic = 0x4b434c4c; // "LLCK"
+  constexpr static const uint32_t checkpoint_version = 3;
+
+  class CheckpointWriter {
+    std::vector<char> buffer;
+  public:
+    template <class T>
+    void write(const T& x) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      const char* bytes = reinterpret_cast<const char*>(&x);
+      buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    /** Write the buffer to `filename.tmp` first, and rename it afterwards, so a previous checkpoint is not lost if we are interrupted while writing. */
+    bool flush(const char* filename) const {
+      std::string tmp = std::string(filename) + ".tmp";
+      FILE* f = std::fopen(tmp.c_str(), "wb");
+      if(f == nullptr) {
+        return false;
+      }
+      bool ok = std::fwrite(buffer.data(), 1, buffer.size(), f) == buffer.size();
+      ok &= std::fclose(f) == 0;
+      return ok && std::rename(tmp.c_str(), filename) == 0;
+    }
+  };
+
+  class CheckpointReader {
+    std::vector<char> buffer;
+    size_t pos;
+  public:
+    CheckpointReader(): pos(0) {}
+
+    bool open(const char* filename) {
+      FILE* f = std::fopen(filename, "rb");
+      if(f == nullptr) {
+        return false;
+      }
+      char chunk[4096];
+      size_t n;
+      while((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        buffer.insert(buffer.end(), chunk, chunk + n);
+      }
+      std::fclose(f);
+      pos = 0;
+      uint32_t magic, version;
+      return read(magic) && read(version) && magic == checkpoint_magic && version == checkpoint_version;
+    }
+
+    template <class T>
+    bool read(T& x) {
+      static_assert(std::is_trivially_copyable_v<T>);
+      if(pos + sizeof(T) > buffer.size()) {
+        return false;
+      }
+      std::memcpy(&x, buffer.data() + pos, sizeof(T));
+      pos += sizeof(T);
+      return true;
+    }
+  };
+
+  template <class Tree>
+  void write_search_tree(CheckpointWriter& w, const Tree& tree) {
+    w.write(checkpoint_magic);
+    w.write(checkpoint_version);
+    const auto& strategies = tree.split->strategies_();
+    w.write(int32_t(strategies.size()));
+    for(int i = 0; i < strategies.size(); ++i) {
+      const auto& vars = strategies[i].vars;
+      w.write(int32_t(vars.size()));
+      for(int j = 0; j < vars.size(); ++j) {
+        w.write(int32_t(vars[j].aty()));
+        w.write(int32_t(vars[j].vid()));
+      }
+    }
+    w.write(uint64_t(tree.num_fails()));
+    w.write(int32_t(tree.tree_exploration()));
+    w.write(int32_t(tree.discrepancy_iteration()));
+    w.write(int8_t(tree.is_budget_exceeded()));
+    w.write(int32_t(tree.depth()));
+    for(int i = 0; i < tree.depth(); ++i) {
+      const auto& branch = tree.branch_at(i);
+      w.write(int32_t(branch.size()));
+      w.write(int32_t(branch.current_index()));
+      w.write(int32_t(branch.var().aty()));
+      w.write(int32_t(branch.var().vid()));
+      w.write(int8_t(branch.has_decision()));
+      if(branch.has_decision()) {
+        w.write(int32_t(branch.decision().left_op));
+        w.write(int32_t(branch.decision().right_op));
+        w.write(int64_t(branch.decision().value));
+      }
+    }
+  }
+
+  template <class Tree, class Propagate>
+  bool read_search_tree(CheckpointReader& r, Tree& tree, Propagate& propagate) {
+    assert(tree.is_singleton());
+    int32_t num_strategies;
+    if(!r.read(num_strategies) || num_strategies != tree.split->num_strategies()) {
+      return false;
+    }
+    for(int i = 0; i < num_strategies; ++i) {
+      int32_t n;
+      if(!r.read(n)) {
+        return false;
+      }
+      battery::vector<AVar, typename Tree::allocator_type> vars(tree.get_allocator());
+      for(int j = 0; j < n; ++j) {
+        int32_t aty, vid;
+        if(!r.read(aty) || !r.read(vid)) {
+          return false;
+        }
+        vars.push_back(AVar(aty, vid));
+      }
+      tree.split->reorder_strategy(i, vars);
+    }
+    uint64_t fails;
+    int32_t exploration, discrepancy_budget, depth;
+    int8_t budget_exceeded;
+    if(!r.read(fails) || !r.read(exploration) || !r.read(discrepancy_budget) || !r.read(budget_exceeded) || !r.read(depth)) {
+      return false;
+    }
+    tree.use_exploration(static_cast<TreeExploration>(exploration));
+    for(int i = 0; i < depth; ++i) {
+      int32_t size, idx, aty, vid, left_op, right_op;
+      int8_t has_decision;
+      int64_t value;
+      if(!r.read(size) || !r.read(idx) || !r.read(aty) || !r.read(vid) || !r.read(has_decision)) {
+        return false;
+      }
+      AVar x = aty == UNTYPED ? AVar{} : AVar(aty, vid);
+      BranchDecision decision{};
+      if(has_decision) {
+        if(!r.read(left_op) || !r.read(right_op) || !r.read(value)) {
+          return false;
+        }
+        decision = BranchDecision{static_cast<Sig>(left_op), static_cast<Sig>(right_op), value};
+      }
+      if(!propagate(tree) || !tree.descend(idx, size, x, has_decision ? &decision : nullptr)) {
+        return false;
+      }
+    }
+    tree.restore_counters(fails, discrepancy_budget, budget_exceeded);
+    return true;
+  }
+}
+
+/** Checkpoints of a search tree, so a search interrupted (e.g., preempted on a cluster) can be resumed from the node it was exploring.
+ *
+ * Rather than serializing the abstract elements, which are not necessarily trivially copyable, a checkpoint contains the path from root to the current node: for each branch, the variable split, its decision (see `BranchDecision`), the number of its children and the index of the child taken.
+ * The branches are built again from their decisions, without the variable and value orders, hence the state learned by the split strategy (e.g., the weights of `DOM_W_DEG`, the activities or the last solution of `SOLUTION`) does not need to be saved to obtain the same branches, and the checkpoint is small (a few bytes per level) and cheap to take every few seconds.
+ * The learned state is not saved, so the search below the current node may use different variables than it would have without interruption, but the remaining subtrees are explored entirely.
+ * The branches without decision (e.g., on non-integer variables) are obtained again by splitting the nodes along the path, and loading the checkpoint fails if the split strategy does not produce the same variable and number of children.
+ * A checkpoint also contains:
+ *   - The variables of each split strategy (to restore the order of `RANDOM` strategies).
+ *   - The counters of the search tree (failures, iteration of LDS/DDS).
+ *   - When a BAB is given, the number of solutions found and the best solution (if its universe is trivially copyable), of which the bound is added again to the search tree.
+ *
+ * A checkpoint must be loaded in a search tree interpreted from the same model as the one saved, and before any call to `deduce()`.
+ *
+ * The open nodes of the frontier (see `SearchTree::use_frontier`) and the formulas added to the search tree but not yet deduced in its root node (see `SearchTree::num_pending_root_tells`) are not saved, since they are not serializable in general.
+ * Hence, no checkpoint is saved while the frontier is not empty, and without BAB, while a formula is pending.
+ * With BAB, the pending formulas are assumed to be the bounds added by BAB (or by `SharedBoundClient`), which are implied by the bound of the best solution added again when loading the checkpoint (a bound of another worker is lost, which only weakens the pruning).
+ *
+ * This is a host-only utility based on `<cstdio>`.
+ *
+ * `save_checkpoint` saves the current node of `tree` in `filename`.
+ * \pre `tree` must not be `bot`, the checkpoint is usually taken right after a call to `deduce()`.
+ * \return `false` if the frontier of `tree` is not empty, if a formula is pending in `tree`, or if the file could not be written. */
+template <class Tree>
+bool save_checkpoint(const char* filename, const Tree& tree) {
+  assert(!tree.is_bot());
+  if(tree.frontier_size() > 0 || tree.num_pending_root_tells() > 0) {
+    return false;
+  }
+  impl::CheckpointWriter w;
+  impl::write_search_tree(w, tree);
+  w.write(int8_t(0));
+  return w.flush(filename);
+}
+
+/** Same as `save_checkpoint(filename, tree)` but also save the best solution found by `bab`, of which `tree` must be the sub-domain.
+ * The formulas pending in `tree` are assumed to be bounds of `bab`, so only a non-empty frontier prevents the checkpoint. */
+template <class Tree, class A, class B>
+bool save_checkpoint(const char* filename, const Tree& tree, const BAB<A, B>& bab) {
+  assert(!tree.is_bot());
+  if(tree.frontier_size() > 0) {
+    return false;
+  }
+  using universe_type = typename B::universe_type;
+  static_assert(std::is_trivially_copyable_v<universe_type>, "The best solution can only be saved if its universe is trivially copyable.");
+  impl::CheckpointWriter w;
+  impl::write_search_tree(w, tree);
+  w.write(int8_t(1));
+  w.write(int32_t(bab.solutions_count()));
+  const B& best = bab.optimum();
+  w.write(int32_t(best.vars()));
+  for(int i = 0; i < best.vars(); ++i) {
+    w.write(best[i]);
+  }
+  return w.flush(filename);
+}
+
+/** Move `tree` to the node saved in `filename`.
+ * `propagate(Tree& tree)` must propagate the current node of `tree` and return `false` if this node is failed (see also `EPS::decompose`).
+ * On return, the current node is not propagated yet, as after a call to `deduce()`.
+ * \pre `tree` must be a singleton interpreted from the same model as the tree saved.
+ * \return `false` if the file could not be read or does not correspond to `tree`, in which case `tree` should be restored to its root. */
+template <class Tree, class Propagate>
+bool load_checkpoint(const char* filename, Tree& tree, Propagate propagate) {
+  impl::CheckpointReader r;
+  return r.open(filename) && impl::read_search_tree(r, tree, propagate);
+}
+
+/** Same as `load_checkpoint(filename, tree, propagate)` but also restore the best solution and the number of solutions of `bab`, and add the bound of the best solution to `tree`.
+ * \pre The objective of `bab` must already be set (as when interpreting the model). */
+template <class Tree, class A, class B, class Propagate>
+bool load_checkpoint(const char* filename, Tree& tree, BAB<A, B>& bab, Propagate propagate) {
+  using universe_type = typename B::universe_type;
+  impl::CheckpointReader r;
+  if(!r.open(filename) || !impl::read_search_tree(r, tree, propagate)) {
+    return false;
+  }
+  int8_t has_bab;
+  int32_t solutions, vars;
+  if(!r.read(has_bab) || !has_bab || !r.read(solutions) || !r.read(vars)) {
+    return false;
+  }
+  B& best = *bab.optimum_ptr();
+  if(vars != best.vars()) {
+    return false;
+  }
+  for(int i = 0; i < vars; ++i) {
+    universe_type u = universe_type::top();
+    if(!r.read(u)) {
+      return false;
+    }
+    best.embed(AVar(best.aty(), i), u);
+  }
+  bab.resume(solutions);
+  return true;
+}
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+// Copyright 2025 Pierre Talbot
+
+#ifndef LALA_POWER_EPS_HPP
+#define LALA_POWER_EPS_HPP
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <optional>
+
+#include "battery/vector.hpp"
+#include "lala/abstract_deps.hpp"
+#include "search_tree.hpp"
+#include "split_strategy.hpp"
+
+namespace lala {
+
+/** Embarrassingly Parallel Search (EPS).
+ * The search tree is first decomposed into a large number of subproblems (e.g., 30 times the number of workers), each subproblem being represented by the path of decisions leading to it from the root node.
+ * The subproblems are then solved independently by the workers, each worker owning a copy of the search tree (usually obtained with the `AbstractDeps` copy constructor).
+ * As opposed to `WorkStealing`, the workers never synchronize except to fetch the next subproblem.
+ *
+ * The decomposition is performed by splitting the nodes in breadth-first order, using either the strategies of the search tree, or a dedicated strategy added with `SplitStrategy::push_eps_strategy` on all variables of the store.
+ * In the latter case, this strategy is skipped when solving the subproblems (see `SplitStrategy::skip_eps_strategy`).
+ *
+ * This is a host-only driver based on `std::thread`.
+ */
+template <class Tree>
+class EPS {
+public:
+  using tree_type = Tree;
+  using tree_ptr = abstract_ptr<tree_type>;
+  using allocator_type = typename tree_type::allocator_type;
+  using path_type = typename tree_type::path_type;
+  using snapshot_type = typename tree_type::template snapshot_type<allocator_type>;
+
+  static_assert(!tree_type::arena_branches, "The trees of the workers are copies of one another, and the copies would share the `NodeArena` of their branches, which is not thread-safe.");
+
+private:
+  std::vector<tree_ptr> trees;
+  // Snapshot of the root node of each tree.
+  std::vector<snapshot_type> roots;
+  std::vector<path_type> subproblems;
+  bool eps_strategy;
+  std::atomic<int> next_subproblem;
+  std::atomic<bool> stop_flag;
+
+  void snapshot_roots() {
+    for(int i = 0; i < trees.size(); ++i) {
+      assert(trees[i]->is_singleton());
+      roots.push_back(trees[i]->snapshot(trees[i]->get_allocator()));
+    }
+  }
+
+public:
+  /** The decomposition uses the strategies of the search tree.
+   * \pre Each tree must be a singleton and represent the same root node. */
+  EPS(const std::vector<tree_ptr>& trees)
+   : trees(trees), eps_strategy(false), next_subproblem(0), stop_flag(false)
+  {
+    assert(trees.size() > 0);
+    snapshot_roots();
+  }
+
+  /** The decomposition uses the strategy `(var_order, val_order)` on all the variables of the store.
+   * \pre Each tree must be a singleton and represent the same root node. */
+  EPS(const std::vector<tree_ptr>& trees, VariableOrder var_order, ValueOrder val_order)
+   : trees(trees), eps_strategy(true), next_subproblem(0), stop_flag(false)
+  {
+    assert(trees.size() > 0);
+    for(int i = 0; i < trees.size(); ++i) {
+      trees[i]->split->push_eps_strategy(var_order, val_order);
+    }
+    snapshot_roots();
+  }
+
+  int num_workers() const {
+    return trees.size();
+  }
+
+  tree_type& tree(int worker) {
+    return *trees[worker];
+  }
+
+  const std::vector<path_type>& subproblems_() const {
+    return subproblems;
+  }
+
+  int num_subproblems() const {
+    return subproblems.size();
+  }
+
+  /** \return the statistics of the search trees of all workers merged together. */
+  SearchStatistics<allocator_type> statistics() const {
+    SearchStatistics<allocator_type> stats(trees[0]->statistics());
+    for(int i = 1; i < num_workers(); ++i) {
+      stats.merge(trees[i]->statistics());
+    }
+    return stats;
+  }
+
+  /** Request all workers to stop, it can be called from `step`. */
+  void stop() {
+    stop_flag = true;
+  }
+
+  /** Split the root node in breadth-first order until at least `target` subproblems are obtained, or until no node can be split anymore.
+   * The decomposition is done sequentially with the tree of the first worker.
+   * `propagate(tree_type& tree)` must propagate the current node of `tree` and return `false` if this node is failed, in which case it is not a subproblem.
+   * \return The number of subproblems, which can be `0` if the problem is unsatisfiable. */
+  template <class Propagate>
+  int decompose(int target, Propagate propagate) {
+    tree_type& t = *trees[0];
+    std::deque<path_type> open;
+    subproblems.clear();
+    open.push_back(path_type(t.get_allocator()));
+    while(!open.empty() && open.size() + subproblems.size() < target) {
+      path_type path = std::move(open.front());
+      open.pop_front();
+      t.restore(roots[0], path);
+      if(!propagate(t)) {
+        continue;
+      }
+      auto branch = t.split->split();
+      // Leaf nodes that are not failed are subproblems solved directly by the workers.
+      if(branch.size() == 0) {
+        subproblems.push_back(std::move(path));
+      }
+      for(int i = 0; i < branch.size(); ++i) {
+        open.push_back(path);
+        open.back().push_back(typename path_type::value_type(branch[i], t.get_allocator()));
+      }
+    }
+    while(!open.empty()) {
+      subproblems.push_back(std::move(open.front()));
+      open.pop_front();
+    }
+    t.restore(roots[0]);
+    return subproblems.size();
+  }
+
+  /** Solve all the subproblems in parallel.
+   * `step(int worker, tree_type& tree)` performs one iteration of the search on the tree of `worker`: propagating the current node, processing a solution if any, and calling `tree.deduce()`.
+   * If `step` returns `false`, all workers are stopped.
+   * \return `true` if all subproblems were explored, `false` if the search was stopped before. */
+  template <class Step>
+  bool run(Step step) {
+    next_subproblem = 0;
+    stop_flag = false;
+    std::vector<std::thread> threads;
+    for(int i = 1; i < num_workers(); ++i) {
+      threads.emplace_back([&, i]() { work(i, step); });
+    }
+    work(0, step);
+    for(int i = 0; i < threads.size(); ++i) {
+      threads[i].join();
+    }
+    return !stop_flag;
+  }
+
+private:
+  template <class Step>
+  void work(int i, Step& step) {
+    tree_type& t = *trees[i];
+    int s;
+    while(!stop_flag && (s = next_subproblem++) < subproblems.size()) {
+      t.restore(roots[i], subproblems[s]);
+      if(eps_strategy) {
+        t.split->skip_eps_strategy();
+      }
+      while(!stop_flag && !t.is_bot()) {
+        if(!step(i, t)) {
+          stop_flag = true;
+        }
+      }
+    }
+  }
+};
+
+} // namespace lala
+
+#endif
@@ -3,6 +3,9 @@
 #ifndef LALA_POWER_LIGHT_BRANCH_HPP
 #define LALA_POWER_LIGHT_BRANCH_HPP
 
+#include "battery/utility.hpp"
+#include "lala/logic/logic.hpp"
+
 /** Similar to `Branch` but specialized to binary search tree splitting over universe (e.g. interval). */
 
 namespace lala {
@@ -28,6 +31,11 @@ struct LightBranch {
     children[1] = right;
   }
 
+  /** \return `0` if the branch is empty (no variable to split), and `2` otherwise. */
+  CUDA INLINE int size() const {
+    return var.is_untyped() ? 0 : 2;
+  }
+
   CUDA INLINE const U& next() {
     assert(has_next());
     return children[++current_idx];
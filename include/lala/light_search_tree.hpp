@@ -0,0 +1,357 @@
+// Copyright 2025 Pierre Talbot
+
+#ifndef LALA_POWER_LIGHT_SEARCH_TREE_HPP
+#define LALA_POWER_LIGHT_SEARCH_TREE_HPP
+
+#include "battery/vector.hpp"
+#include "battery/shared_ptr.hpp"
+#include "lala/logic/logic.hpp"
+#include "lala/abstract_deps.hpp"
+
+#include "light_branch.hpp"
+#include "search_tree.hpp"
+#include "search_statistics.hpp"
+
+namespace lala {
+
+template <class A, class S, class Allocator> class LightSearchTree;
+namespace impl {
+  template <class>
+  struct is_light_search_tree_like {
+    static constexpr bool value = false;
+  };
+  template<class A, class S, class Alloc>
+  struct is_light_search_tree_like<LightSearchTree<A, S, Alloc>> {
+    static constexpr bool value = true;
+  };
+}
+
+/** A search tree specialized to binary splits over the universe of a variable (e.g., `x <= k \/ x > k` over intervals).
+ * As opposed to `SearchTree`, which stores each branch as a vector of tells, a branch is a `LightBranch` made of a variable, two universes and two ropes, and the children are applied by embedding the universe in the variable (`a->embed(x, u)`).
+ * Hence, a node only takes a few words of memory and no dynamic allocation.
+ * The rope of a child is the depth of the nearest branch with an unexplored child when this child is a leaf, hence on backtracking we directly jump to this depth instead of popping each explored branch.
+ * The nodes are explored in depth-first order, and we backtrack by restoring the root node and replaying the decisions (full recomputation), which is cheap since embedding a universe is cheap.
+ *
+ * The split strategy must provide `split_light()` (see `SplitStrategy`) and the sub-domain must support `embed(AVar, local_universe)`.
+ * The tells are the same as those of `SearchTree`. */
+template <class A, class Split, class Allocator = typename A::allocator_type>
+class LightSearchTree {
+public:
+  using allocator_type = Allocator;
+  using sub_allocator_type = typename A::allocator_type;
+  using split_type = Split;
+  using universe_type = typename A::universe_type;
+  using local_universe = typename universe_type::local_type;
+  using branch_type = LightBranch<local_universe>;
+  using sub_type = A;
+  using sub_ptr = abstract_ptr<sub_type>;
+  using split_ptr = abstract_ptr<split_type>;
+  using this_type = LightSearchTree<sub_type, split_type, allocator_type>;
+
+  constexpr static const bool is_abstract_universe = false;
+  constexpr static const bool sequential = sub_type::sequential;
+  constexpr static const bool is_totally_ordered = false;
+  constexpr static const bool preserve_bot = true;
+  constexpr static const bool preserve_top = true;
+  constexpr static const bool preserve_join = sub_type::preserve_join;
+  constexpr static const bool preserve_meet = sub_type::preserve_meet;
+  constexpr static const bool injective_concretization = sub_type::injective_concretization;
+  constexpr static const bool preserve_concrete_covers = sub_type::preserve_concrete_covers;
+  constexpr static const char* name = "LightSearchTree";
+
+  template <class Alloc>
+  using tell_type = typename SearchTree<A, Split, Allocator>::template tell_type<Alloc>;
+
+  template<class Alloc>
+  using ask_type = typename A::template ask_type<Alloc>;
+
+  template <class A2, class S2, class Alloc2>
+  friend class LightSearchTree;
+
+  split_ptr split;
+private:
+  AType atype;
+  // `a` reflects the current node of the search tree, it is `nullptr` when the search tree is empty.
+  sub_ptr a;
+  battery::vector<branch_type, allocator_type> stack;
+  using sub_snapshot_type = sub_type::template snapshot_type<allocator_type>;
+  using split_snapshot_type = split_type::template snapshot_type<allocator_type>;
+  using root_type = battery::tuple<sub_snapshot_type, split_snapshot_type>;
+  root_type root;
+  // Projection of the variables of the split strategy in the root node, updated whenever `root` is snapshotted (see `project`).
+  battery::vector<local_universe, allocator_type> root_projection;
+
+  // Tell formulas (and strategies) to be added to root on backtracking (see `SearchTree`).
+  struct root_tell_type {
+    battery::vector<typename A::template tell_type<allocator_type>, allocator_type> sub_tells;
+    battery::vector<typename split_type::template tell_type<allocator_type>, allocator_type> split_tells;
+    CUDA root_tell_type(const allocator_type& alloc): sub_tells(alloc), split_tells(alloc) {}
+    template <class RootTellType>
+    CUDA root_tell_type(const RootTellType& other, const allocator_type& alloc)
+     : sub_tells(other.sub_tells, alloc), split_tells(other.split_tells, alloc) {}
+  };
+  root_tell_type root_tell;
+
+  SearchStatistics<allocator_type> stats;
+
+public:
+  CUDA LightSearchTree(AType uid, sub_ptr a, split_ptr split, const allocator_type& alloc = allocator_type())
+   : atype(uid)
+   , a(std::move(a))
+   , split(std::move(split))
+   , stack(alloc)
+   , root(battery::make_tuple(this->a->snapshot(alloc), this->split->snapshot(alloc)))
+   , root_projection(alloc)
+   , root_tell(alloc)
+   , stats(alloc)
+  {
+    project_root();
+  }
+
+  template<class A2, class S2, class Alloc2, class... Allocators>
+  CUDA NI LightSearchTree(const LightSearchTree<A2, S2, Alloc2>& other, AbstractDeps<Allocators...>& deps)
+   : atype(other.atype)
+   , a(deps.template clone<sub_type>(other.a))
+   , split(deps.template clone<split_type>(other.split))
+   , stack(other.stack, deps.template get_allocator<allocator_type>())
+   , root(
+      sub_snapshot_type(battery::get<0>(other.root), deps.template get_allocator<allocator_type>()),
+      split_snapshot_type(battery::get<1>(other.root), deps.template get_allocator<allocator_type>()))
+   , root_projection(other.root_projection, deps.template get_allocator<allocator_type>())
+   , root_tell(other.root_tell, deps.template get_allocator<allocator_type>())
+   , stats(other.stats, deps.template get_allocator<allocator_type>())
+  {}
+
+  CUDA AType aty() const {
+    return atype;
+  }
+
+  CUDA allocator_type get_allocator() const {
+    return stack.get_allocator();
+  }
+
+  CUDA local::B is_singleton() const {
+    return stack.empty() && bool(a);
+  }
+
+  CUDA local::B is_top() const {
+    return is_singleton() && a->is_top();
+  }
+
+  CUDA local::B is_bot() const {
+    return !bool(a);
+  }
+
+  template <bool diagnose = false, class F, class Env, class Alloc2>
+  CUDA NI bool interpret_tell(const F& f, Env& env, tell_type<Alloc2>& tell, IDiagnostics& diagnostics) const {
+    assert(!is_bot());
+    if(f.is(F::ESeq) && f.esig() == "search") {
+      return split->template interpret_tell<diagnose>(f, env, tell.split_tell, diagnostics);
+    }
+    else {
+      return a->template interpret_tell<diagnose>(f, env, tell.sub_tell, diagnostics);
+    }
+  }
+
+  template <bool diagnose = false, class F, class Env, class Alloc2>
+  CUDA NI bool interpret_ask(const F& f, Env& env, ask_type<Alloc2>& ask, IDiagnostics& diagnostics) const {
+    assert(!is_bot());
+    return a->template interpret_ask<diagnose>(f, env, ask, diagnostics);
+  }
+
+  template <IKind kind, bool diagnose = false, class F, class Env, class I>
+  CUDA NI bool interpret(const F& f, Env& env, I& intermediate, IDiagnostics& diagnostics) const {
+    if constexpr(kind == IKind::TELL) {
+      return interpret_tell<diagnose>(f, env, intermediate, diagnostics);
+    }
+    else {
+      return interpret_ask<diagnose>(f, env, intermediate, diagnostics);
+    }
+  }
+
+  template <class Alloc>
+  CUDA local::B deduce(const tell_type<Alloc>& t) {
+    if(!is_bot()) {
+      if(!is_singleton()) {
+        root_tell.sub_tells.push_back(t.sub_tell);
+        root_tell.split_tells.push_back(t.split_tell);
+      }
+      local::B has_changed = a->deduce(t.sub_tell);
+      has_changed |= split->deduce(t.split_tell);
+      return has_changed;
+    }
+    return false;
+  }
+
+  /** Perform one iteration of \f$ \mathit{pop} \circ \mathit{push} \circ \mathit{split} \f$ (see `SearchTree::deduce`). */
+  CUDA bool deduce() {
+    return pop(push(split->split_light()));
+  }
+
+  template <class ExtractionStrategy = NonAtomicExtraction>
+  CUDA bool is_extractable(const ExtractionStrategy& strategy = ExtractionStrategy()) const {
+    return !is_bot() && a->is_extractable(strategy);
+  }
+
+  template <class B>
+  CUDA void extract(B& ua) const {
+    if constexpr(impl::is_light_search_tree_like<B>::value) {
+      assert(bool(ua.a));
+      a->extract(*ua.a);
+      ua.stack.clear();
+      ua.root_tell.sub_tells.clear();
+      ua.root_tell.split_tells.clear();
+    }
+    else {
+      a->extract(ua);
+    }
+  }
+
+  /** As `SearchTree::project`: on a search tree with multiple nodes, we return the projection of `x` in the root node, which is cached when the root node is snapshotted, and only the variables of the split strategy can be projected.
+   * The cache is not shared with other threads, hence `project` must not be called concurrently with the search. */
+  CUDA local_universe project(AVar x) const {
+    if(is_bot()) {
+      return local_universe::bot();
+    }
+    else if(is_singleton()) {
+      return a->project(x);
+    }
+    else if(x.aty() == split->var_aty_() && x.vid() < root_projection.size()) {
+      return root_projection[x.vid()];
+    }
+    else {
+      return local_universe::top();
+    }
+  }
+
+  /** \return the current depth of the search tree. The root node has a depth of 0. */
+  CUDA int depth() const {
+    return stack.size();
+  }
+
+  CUDA size_t num_fails() const {
+    return stats.fails;
+  }
+
+  CUDA const SearchStatistics<allocator_type>& statistics() const {
+    return stats;
+  }
+
+  CUDA SearchStatistics<allocator_type>& statistics() {
+    return stats;
+  }
+
+private:
+  /** \return `true` if the current node is pruned, and `false` if a new branch was pushed. */
+  CUDA bool push(branch_type&& branch) {
+    if(branch.size() > 0) {
+      int d = stack.size();
+      if(d == 0) {
+        root = battery::make_tuple(
+          a->snapshot(get_allocator()),
+          split->snapshot(get_allocator()));
+        project_root();
+        branch.ropes[1] = -1;
+      }
+      else {
+        // The right child backtracks to the parent if we are in its left child, and otherwise where the parent would backtrack.
+        const branch_type& parent = stack[d - 1];
+        branch.ropes[1] = parent.current_idx == 0 ? d - 1 : parent.ropes[1];
+      }
+      branch.ropes[0] = d;
+      stack.push_back(std::move(branch));
+      return false;
+    }
+    return true;
+  }
+
+  CUDA bool pop(bool pruned) {
+    if(!pruned) {
+      return commit_left();
+    }
+    else {
+      if(a && a->is_bot()) {
+        ++stats.fails;
+        if(!stack.empty()) {
+          split->on_failure(stack.back().var, stack.back().current_idx);
+        }
+      }
+      return backtrack();
+    }
+  }
+
+  CUDA bool commit_left() {
+    assert(bool(a));
+    stats.record_node(stack.size());
+    branch_type& b = stack.back();
+    return a->embed(b.var, b.next());
+  }
+
+  /** Jump to the branch given by the rope of the current node, and explore its right child. */
+  CUDA bool backtrack() {
+    ++stats.backtracks;
+    int target = stack.empty() ? -1 : stack.back().ropes[stack.back().current_idx];
+    if(target == -1) {
+      if(a) {
+        stack.clear();
+        a = nullptr;
+        return true;
+      }
+      return false;
+    }
+    stack.resize(target + 1);
+    a->restore(battery::get<0>(root));
+    split->restore(battery::get<1>(root));
+    deduce_root();
+    stack.back().next();
+    stats.record_node(stack.size());
+    return replay();
+  }
+
+  CUDA bool replay() {
+    bool has_changed = false;
+    for(int i = 0; i < stack.size(); ++i) {
+      if(i + 1 == stack.size()) {
+        split->on_commit(stack[i].var, stack[i].current_idx);
+      }
+      has_changed |= a->embed(stack[i].var, stack[i].current());
+    }
+    stats.replayed_deductions += stack.size();
+    split->on_replayed(stack.back().var);
+    return has_changed;
+  }
+
+  CUDA bool deduce_root() {
+    bool has_changed = false;
+    if(root_tell.sub_tells.size() > 0 || root_tell.split_tells.size() > 0) {
+      for(int i = 0; i < root_tell.sub_tells.size(); ++i) {
+        has_changed |= a->deduce(root_tell.sub_tells[i]);
+      }
+      for(int i = 0; i < root_tell.split_tells.size(); ++i) {
+        has_changed |= split->deduce(root_tell.split_tells[i]);
+      }
+      root_tell.sub_tells.clear();
+      root_tell.split_tells.clear();
+      root = battery::make_tuple(
+        a->snapshot(get_allocator()),
+        split->snapshot(get_allocator()));
+      project_root();
+    }
+    return has_changed;
+  }
+
+  /** Cache the projection of the variables in the current node, which must be the root node. */
+  CUDA NI void project_root() {
+    if(root_projection.size() != a->vars()) {
+      root_projection.resize(a->vars());
+    }
+    AType var_aty = split->var_aty_();
+    for(int i = 0; i < a->vars(); ++i) {
+      root_projection[i] = a->project(AVar(var_aty, i));
+    }
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,204 @@
+// Copyright 2025 Pierre Talbot
+
+#ifndef LALA_POWER_LNS_HPP
+#define LALA_POWER_LNS_HPP
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "lala/logic/logic.hpp"
+#include "search_tree.hpp"
+#include "bab.hpp"
+
+namespace lala {
+
+/** Relaxation operator of `LNS` choosing the variables to relax uniformly at random.
+ * A relaxation operator is called with the number of variables `n`, the number of variables to relax `k` and a random generator, and must fill `fixed` with the indices (in `[0..n)`) of the variables to fix to their value in the incumbent. */
+class RandomRelaxation {
+  std::vector<int> perm;
+
+public:
+  template <class RNG>
+  void operator()(int n, int k, RNG& rng, std::vector<int>& fixed) {
+    perm.resize(n);
+    for(int i = 0; i < n; ++i) {
+      perm[i] = i;
+    }
+    std::shuffle(perm.begin(), perm.end(), rng);
+    fixed.assign(perm.begin() + k, perm.end());
+  }
+};
+
+/** Relaxation operator of `LNS` relaxing a window of `k` consecutive variables (e.g., consecutive tasks in a schedule), the window starting where the previous one ended.
+ * Its position is not random, but the random generator is accepted for compatibility with `RandomRelaxation`. */
+class WindowRelaxation {
+  int start;
+
+public:
+  WindowRelaxation(): start(0) {}
+
+  template <class RNG>
+  void operator()(int n, int k, RNG&, std::vector<int>& fixed) {
+    fixed.clear();
+    start = n == 0 ? 0 : start % n;
+    for(int i = k; i < n; ++i) {
+      fixed.push_back((start + i) % n);
+    }
+    start += k;
+  }
+};
+
+/** Large Neighborhood Search (LNS) on top of branch-and-bound.
+ * Each iteration restores the root node of the search tree, fixes a subset of the variables to their value in the incumbent `bab.optimum()` (chosen by the relaxation operator), adds the bound of the incumbent, and explores the neighborhood obtained until a limit of nodes is reached.
+ * The search tree is reused across the iterations: it is restored from a snapshot of its root node taken at construction.
+ *
+ * The number of relaxed variables is adapted after each iteration: it decreases when the node limit was reached without improving the incumbent (the neighborhood was too large), and it increases when the neighborhood was exhausted without improvement.
+ * When a neighborhood without any fixed variable is exhausted, the incumbent is optimal (or the problem is unsatisfiable if there is no incumbent), see `is_complete`.
+ * When there is no incumbent, an iteration searches for a first solution without fixing any variable.
+ *
+ * This is a host-only driver, the randomness is derived from `seed` so runs are reproducible.
+ */
+template <class Tree, class Best, class Relaxation = RandomRelaxation>
+class LNS {
+public:
+  using tree_type = Tree;
+  using tree_ptr = abstract_ptr<tree_type>;
+  using bab_type = BAB<tree_type, Best>;
+  using allocator_type = typename tree_type::allocator_type;
+  using snapshot_type = typename tree_type::template snapshot_type<allocator_type>;
+
+private:
+  tree_ptr tree;
+  bab_type& bab;
+  std::vector<AVar> vars;
+  Relaxation relaxation;
+  snapshot_type root;
+  std::mt19937 rng;
+  size_t node_limit;
+  // Fraction of the variables relaxed in the next iteration, between `min_rate` and `1`.
+  double rate;
+  double min_rate;
+  double rate_factor;
+  int iterations;
+  int improvements;
+  bool complete;
+  std::vector<int> fixed;
+
+  /** Fix the variable `x` to its value in the incumbent at the root node of the tree. */
+  bool fix(AVar x) {
+    using F = TFormula<allocator_type>;
+    auto v = bab.optimum().project(x);
+    if(v.lb().value() != v.ub().value()) {
+      return true;
+    }
+    VarEnv<allocator_type> empty_env{};
+    IDiagnostics diagnostics;
+    typename tree_type::template tell_type<allocator_type> t(tree->get_allocator());
+    F f = F::make_binary(F::make_avar(x), EQ, v.lb().template deinterpret<F>(), x.aty(), tree->get_allocator());
+    if(!tree->interpret_tell(f, empty_env, t, diagnostics)) {
+      return false;
+    }
+    tree->deduce(t);
+    return true;
+  }
+
+public:
+  /** \param vars The variables fixed in the neighborhoods, usually the decision variables.
+   * \param node_limit The number of nodes explored in each neighborhood.
+   * \param rate The initial fraction of `vars` relaxed.
+   * \pre `tree` must be a singleton (its root node is restored at each iteration), and be the sub-domain of `bab`. */
+  LNS(tree_ptr tree, bab_type& bab, const std::vector<AVar>& vars, size_t node_limit = 1000,
+    double rate = 0.2, unsigned int seed = 0, const Relaxation& relaxation = Relaxation())
+   : tree(tree), bab(bab), vars(vars), relaxation(relaxation)
+   , root(tree->snapshot(tree->get_allocator()))
+   , rng(seed), node_limit(node_limit), rate(rate)
+   , min_rate(vars.empty() ? 1.0 : 1.0 / vars.size()), rate_factor(1.2)
+   , iterations(0), improvements(0), complete(false)
+  {
+    assert(node_limit > 0);
+    this->rate = battery::min(1.0, battery::max(min_rate, rate));
+  }
+
+  /** Explore the next neighborhood, `propagate()` must compute the deduction of the sub-domain of the tree in the current node (e.g., the fixpoint of the propagators).
+   * \return `true` if the incumbent was improved. */
+  template <class Propagate>
+  bool iterate(Propagate propagate) {
+    if(complete) {
+      return false;
+    }
+    ++iterations;
+    tree->restore(root);
+    fixed.clear();
+    int n = vars.size();
+    if(bab.solutions_count() > 0) {
+      int k = battery::max(1, static_cast<int>(rate * n + 0.5));
+      relaxation(n, battery::min(k, n), rng, fixed);
+      for(int i = 0; i < fixed.size(); ++i) {
+        if(!fix(vars[fixed[i]])) {
+          printf("%% WARNING: LNS cannot fix a variable to its value in the incumbent.\n");
+        }
+      }
+      bab.resume(bab.solutions_count());
+    }
+    size_t start_nodes = tree->statistics().nodes;
+    int start_solutions = bab.solutions_count();
+    while(!tree->is_bot() && tree->statistics().nodes - start_nodes < node_limit) {
+      propagate();
+      if(tree->is_extractable()) {
+        bab.deduce();
+      }
+      tree->deduce();
+    }
+    bool improved = bab.solutions_count() > start_solutions;
+    improvements += improved;
+    if(tree->is_bot()) {
+      complete = fixed.empty();
+      if(!improved) {
+        rate = battery::min(1.0, rate * rate_factor);
+      }
+    }
+    else if(!improved) {
+      rate = battery::max(min_rate, rate / rate_factor);
+    }
+    return improved;
+  }
+
+  /** Explore at most `max_iterations` neighborhoods, or until `is_complete()`.
+   * \return the number of iterations that improved the incumbent. */
+  template <class Propagate>
+  int run(Propagate propagate, int max_iterations) {
+    int improved = 0;
+    for(int i = 0; i < max_iterations && !complete; ++i) {
+      improved += iterate(propagate);
+    }
+    return improved;
+  }
+
+  /** `true` if a neighborhood without fixed variables was exhausted, hence the incumbent is optimal, or the problem is unsatisfiable when there is no incumbent. */
+  bool is_complete() const {
+    return complete;
+  }
+
+  int num_iterations() const {
+    return iterations;
+  }
+
+  int num_improvements() const {
+    return improvements;
+  }
+
+  /** The fraction of the variables relaxed in the next iteration. */
+  double relaxation_rate() const {
+    return rate;
+  }
+
+  void set_node_limit(size_t limit) {
+    assert(limit > 0);
+    node_limit = limit;
+  }
+};
+
+} // namespace lala
+
+#endif
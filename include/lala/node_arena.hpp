@@ -0,0 +1,173 @@
+// Copyright 2025 Pierre Talbot
+
+#ifndef LALA_POWER_NODE_ARENA_HPP
+#define LALA_POWER_NODE_ARENA_HPP
+
+#include <cstddef>
+
+#include "battery/utility.hpp"
+#include "battery/allocator.hpp"
+#include "battery/vector.hpp"
+
+namespace lala {
+
+/** A bump allocator organized in levels, one level per depth of the search tree.
+ * The memory of a level is released all at once when the level is popped, hence allocating the children of a branch costs a pointer increment, and freeing them costs nothing.
+ * The memory is obtained by blocks of `block_size` bytes from `Allocator`, and the blocks are kept for reuse until the arena is destroyed.
+ * The arena is not thread-safe: each search tree must have its own arena.
+ * See `arena_allocator` to use it as the `BranchAllocator` of `SplitStrategy`. */
+template <class Allocator = battery::standard_allocator>
+class NodeArena {
+public:
+  using allocator_type = Allocator;
+
+private:
+  struct block_type {
+    char* data;
+    size_t capacity;
+  };
+
+  struct mark_type {
+    int block;
+    size_t offset;
+  };
+
+  // Objects allocated in the arena are aligned on the strictest fundamental alignment.
+  constexpr static const size_t alignment = alignof(std::max_align_t);
+
+  allocator_type alloc;
+  size_t block_size;
+  battery::vector<block_type, allocator_type> blocks;
+  battery::vector<mark_type, allocator_type> levels;
+  // The next allocation is done at `blocks[current].data + offset`.
+  int current;
+  size_t offset;
+
+  CUDA NI void next_block(size_t bytes) {
+    ++current;
+    if(current < blocks.size() && blocks[current].capacity < bytes) {
+      alloc.deallocate(blocks[current].data);
+      blocks[current].data = static_cast<char*>(alloc.allocate(bytes));
+      blocks[current].capacity = bytes;
+    }
+    else if(current == blocks.size()) {
+      size_t capacity = battery::max(block_size, bytes);
+      blocks.push_back(block_type{static_cast<char*>(alloc.allocate(capacity)), capacity});
+    }
+    offset = 0;
+  }
+
+public:
+  CUDA NodeArena(size_t block_size = 1 << 16, const allocator_type& alloc = allocator_type())
+   : alloc(alloc), block_size(block_size), blocks(alloc), levels(alloc), current(-1), offset(0)
+  {}
+
+  NodeArena(const NodeArena&) = delete;
+  NodeArena& operator=(const NodeArena&) = delete;
+
+  CUDA ~NodeArena() {
+    for(int i = 0; i < blocks.size(); ++i) {
+      alloc.deallocate(blocks[i].data);
+    }
+  }
+
+  CUDA void* allocate(size_t bytes) {
+    if(bytes == 0) {
+      return nullptr;
+    }
+    bytes = (bytes + alignment - 1) / alignment * alignment;
+    if(current == -1 || offset + bytes > blocks[current].capacity) {
+      next_block(bytes);
+    }
+    void* data = blocks[current].data + offset;
+    offset += bytes;
+    return data;
+  }
+
+  /** Start a new level, the memory allocated from now on is released by the next call to `pop_level`. */
+  CUDA void push_level() {
+    levels.push_back(mark_type{current, offset});
+  }
+
+  CUDA void pop_level() {
+    assert(levels.size() > 0);
+    current = levels.back().block;
+    offset = levels.back().offset;
+    levels.pop_back();
+  }
+
+  CUDA int num_levels() const {
+    return levels.size();
+  }
+
+  /** Release all levels, the blocks are kept for reuse. */
+  CUDA void reset() {
+    levels.clear();
+    current = -1;
+    offset = 0;
+  }
+
+  /** \return the number of bytes reserved from `Allocator`. */
+  CUDA size_t capacity() const {
+    size_t bytes = 0;
+    for(int i = 0; i < blocks.size(); ++i) {
+      bytes += blocks[i].capacity;
+    }
+    return bytes;
+  }
+};
+
+/** An allocator in the style of `battery::standard_allocator`, allocating from a `NodeArena`.
+ * Deallocation is a no-op, the memory is released when the level of the arena is popped.
+ * A default constructed `arena_allocator` is not bound to an arena, and allocates and deallocates with `Allocator` instead. */
+template <class Allocator = battery::standard_allocator>
+class arena_allocator {
+public:
+  using arena_type = NodeArena<Allocator>;
+
+private:
+  arena_type* arena;
+  Allocator fallback;
+
+public:
+  CUDA arena_allocator(arena_type* arena = nullptr, const Allocator& fallback = Allocator())
+   : arena(arena), fallback(fallback)
+  {}
+
+  arena_allocator(const arena_allocator&) = default;
+  arena_allocator& operator=(const arena_allocator&) = default;
+
+  CUDA void* allocate(size_t bytes) {
+    return arena == nullptr ? fallback.allocate(bytes) : arena->allocate(bytes);
+  }
+
+  CUDA void deallocate(void* data) {
+    if(arena == nullptr) {
+      fallback.deallocate(data);
+    }
+  }
+
+  CUDA void push_level() {
+    if(arena != nullptr) {
+      arena->push_level();
+    }
+  }
+
+  CUDA void pop_level() {
+    if(arena != nullptr) {
+      arena->pop_level();
+    }
+  }
+
+  CUDA arena_type* arena_() const {
+    return arena;
+  }
+
+  CUDA bool operator==(const arena_allocator& other) const {
+    return arena == other.arena;
+  }
+};
+
+}
+
+#endif
@@ -0,0 +1,204 @@
+// Copyright 2025 Pierre Talbot
+
+#ifndef LALA_POWER_PORTFOLIO_HPP
+#define LALA_POWER_PORTFOLIO_HPP
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <random>
+
+#include "lala/abstract_deps.hpp"
+#include "search_tree.hpp"
+#include "split_strategy.hpp"
+#include "bab.hpp"
+#include "shared_bound.hpp"
+
+namespace lala {
+
+/** A strategy on all the variables tried by a worker of `Portfolio`. */
+struct PortfolioStrategy {
+  VariableOrder var_order;
+  ValueOrder val_order;
+};
+
+/** A parallel portfolio: each worker explores the whole search tree with its own copy of the search tree and of `BAB` (usually obtained with the `AbstractDeps` copy constructor), but with a different strategy.
+ * The first worker keeps the strategies of the model, and the worker `i > 0` searches with the strategy `strategies[(i - 1) % strategies.size()]` on all variables, added in front of the strategies of the model (see `SplitStrategy::push_eps_strategy`).
+ * In addition, the variables of the strategies with a `RANDOM` variable order are shuffled with a seed derived from `seed` and the index of the worker, so the configuration of each worker is reproducible.
+ *
+ * In optimization problems with a single objective, the workers share their incumbents with a `SharedBound`, hence a bound found by one worker prunes the search trees of the others.
+ * With several objectives (optimized in lexicographic order), the bounds are not shared and each worker only prunes its own search tree.
+ * As soon as one worker exhausts its search tree, its best solution is optimal (or the problem is unsatisfiable), and all workers stop.
+ * In satisfaction problems, all workers stop as soon as one of them finds a solution.
+ *
+ * This is a host-only driver based on `std::thread`.
+ */
+template <class Tree, class Best>
+class Portfolio {
+public:
+  using tree_type = Tree;
+  using tree_ptr = abstract_ptr<tree_type>;
+  using bab_type = BAB<tree_type, Best>;
+  using bab_ptr = abstract_ptr<bab_type>;
+  using allocator_type = typename tree_type::allocator_type;
+
+  static_assert(!tree_type::arena_branches, "The trees of the workers are copies of one another, and the copies would share the `NodeArena` of their branches, which is not thread-safe.");
+
+private:
+  std::vector<tree_ptr> trees;
+  std::vector<bab_ptr> babs;
+  std::unique_ptr<SharedBound> shared;
+  std::atomic<bool> stop_flag;
+  std::atomic<int> winner;
+
+public:
+  /** The strategies used by default to diversify the workers. */
+  static std::vector<PortfolioStrategy> default_strategies() {
+    return {
+      {VariableOrder::FIRST_FAIL, ValueOrder::MIN},
+      {VariableOrder::DOM_W_DEG, ValueOrder::SPLIT},
+      {VariableOrder::RANDOM, ValueOrder::MIN},
+      {VariableOrder::ANTI_FIRST_FAIL, ValueOrder::MAX},
+      {VariableOrder::INPUT_ORDER, ValueOrder::SOLUTION},
+      {VariableOrder::FIRST_FAIL, ValueOrder::REVERSE_SPLIT}
+    };
+  }
+
+  /** \param babs `babs[i]` must have `trees[i]` as sub-domain.
+   * \param num_vars The number of variables of the solutions shared between the workers (see `SharedBound`).
+   * \pre Each tree must be a singleton and represent the same root node, and all `BAB` must have the same objective. */
+  Portfolio(const std::vector<tree_ptr>& trees, const std::vector<bab_ptr>& babs, int num_vars, unsigned int seed = 0,
+    const std::vector<PortfolioStrategy>& strategies = default_strategies())
+   : trees(trees), babs(babs), stop_flag(false), winner(-1)
+  {
+    assert(trees.size() > 0);
+    assert(trees.size() == babs.size());
+    assert(strategies.size() > 0);
+    for(int i = 0; i < trees.size(); ++i) {
+      assert(trees[i]->is_singleton());
+      if(i > 0) {
+        const PortfolioStrategy& s = strategies[(i - 1) % strategies.size()];
+        trees[i]->split->push_eps_strategy(s.var_order, s.val_order);
+      }
+      std::seed_seq seq{seed, static_cast<unsigned int>(i)};
+      std::mt19937 rng(seq);
+      trees[i]->split->shuffle_random_strategies(rng);
+    }
+    if(babs[0]->num_objectives() == 1) {
+      shared = std::make_unique<SharedBound>(babs[0]->is_minimization(), num_vars);
+    }
+  }
+
+  int num_workers() const {
+    return trees.size();
+  }
+
+  tree_type& tree(int worker) {
+    return *trees[worker];
+  }
+
+  bab_type& bab(int worker) {
+    return *babs[worker];
+  }
+
+  /** The bound and the best solution shared by the workers, `nullptr` in satisfaction problems and with several objectives. */
+  const SharedBound* shared_bound() const {
+    return shared.get();
+  }
+
+  /** \return the worker that exhausted its search tree (or found a solution in satisfaction problems) during the last call to `run`, or `-1` if the search was stopped before. */
+  int winning_worker() const {
+    return winner;
+  }
+
+  /** \return the worker with the best solution, or `-1` if no solution was found. */
+  int best_worker() const {
+    int best = -1;
+    for(int i = 0; i < num_workers(); ++i) {
+      if(babs[i]->solutions_count() > 0
+       && (best == -1 || (babs[i]->is_optimization() && babs[i]->compare_bound(babs[i]->optimum(), babs[best]->optimum()))))
+      {
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  /** \return the statistics of the search trees of all workers merged together. */
+  SearchStatistics<allocator_type> statistics() const {
+    SearchStatistics<allocator_type> stats(trees[0]->statistics());
+    for(int i = 1; i < num_workers(); ++i) {
+      stats.merge(trees[i]->statistics());
+    }
+    return stats;
+  }
+
+  /** Request all workers to stop, it can be called from `propagate`. */
+  void stop() {
+    stop_flag = true;
+  }
+
+  bool is_stopped() const {
+    return stop_flag;
+  }
+
+  /** Run the workers until one of them completes or `stop()` is called.
+   * `propagate(int worker)` must compute the deduction of the sub-domain of the tree of `worker` in its current node (e.g., the fixpoint of the propagators), it is called concurrently on different workers.
+   * \return `true` if the search is complete: the best solution is optimal, or the problem is unsatisfiable, or a solution was found in a satisfaction problem. */
+  template <class Propagate>
+  bool run(Propagate propagate) {
+    stop_flag = false;
+    winner = -1;
+    std::vector<std::thread> threads;
+    for(int i = 1; i < num_workers(); ++i) {
+      threads.emplace_back([&, i]() { work(i, propagate); });
+    }
+    work(0, propagate);
+    for(int i = 0; i < threads.size(); ++i) {
+      threads[i].join();
+    }
+    return winner != -1;
+  }
+
+private:
+  template <class Propagate>
+  void work(int i, Propagate& propagate) {
+    tree_type& t = *trees[i];
+    bab_type& b = *babs[i];
+    std::unique_ptr<SharedBoundClient<bab_type>> client;
+    if(shared) {
+      client = std::make_unique<SharedBoundClient<bab_type>>(*shared, b);
+    }
+    while(!stop_flag && !t.is_bot()) {
+      if(client) {
+        client->poll();
+      }
+      propagate(i);
+      if(t.is_extractable()) {
+        b.deduce();
+        if(client) {
+          client->publish();
+        }
+        else if(b.is_satisfaction()) {
+          finish(i);
+          return;
+        }
+      }
+      t.deduce();
+    }
+    if(t.is_bot()) {
+      finish(i);
+    }
+  }
+
+  void finish(int i) {
+    int expected = -1;
+    winner.compare_exchange_strong(expected, i);
+    stop_flag = true;
+  }
+};
+
+} // namespace lala
+
+#endif
@@ -0,0 +1,134 @@
+// Copyright 2025 Pierre Talbot
+
+#ifndef LALA_POWER_RESTART_HPP
+#define LALA_POWER_RESTART_HPP
+
+#include <random>
+#include <optional>
+#include <cmath>
+
+#include "lala/logic/logic.hpp"
+
+namespace lala {
+
+enum class RestartPolicy {
+  NONE,
+  CONSTANT,
+  GEOMETRIC,
+  LUBY
+};
+
+inline const char* string_of_restart_policy(RestartPolicy policy) {
+  switch(policy) {
+    case RestartPolicy::NONE: return "none";
+    case RestartPolicy::CONSTANT: return "constant";
+    case RestartPolicy::GEOMETRIC: return "geometric";
+    case RestartPolicy::LUBY: return "luby";
+    default: return "unknown";
+  }
+}
+
+template <class StringType>
+std::optional<RestartPolicy> restart_policy_of_string(const StringType& str) {
+  if(str == "none") {
+    return RestartPolicy::NONE;
+  }
+  else if(str == "constant") {
+    return RestartPolicy::CONSTANT;
+  }
+  else if(str == "geometric") {
+    return RestartPolicy::GEOMETRIC;
+  }
+  else if(str == "luby") {
+    return RestartPolicy::LUBY;
+  }
+  else {
+    return std::nullopt;
+  }
+}
+
+/** The Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ...
+ * \pre `i >= 1`. */
+CUDA inline long luby(long i) {
+  assert(i >= 1);
+  while(true) {
+    long k = 1;
+    while((1L << k) - 1 < i) {
+      ++k;
+    }
+    if(i == (1L << k) - 1) {
+      return 1L << (k - 1);
+    }
+    i = i - (1L << (k - 1)) + 1;
+  }
+}
+
+/** A restart controller for a search tree, it restarts the search from the root node when the number of failed nodes since the last restart (see `SearchTree::num_fails`) reaches a cutoff.
+ * The cutoffs follow the sequence `base, base, ..., base` (constant), `base, base * factor, base * factor^2, ...` (geometric) or `base * luby(1), base * luby(2), ...` (Luby).
+ * On each restart, the variables of the strategies with a `RANDOM` variable order are shuffled using a seed derived from the initial seed and the number of restarts, so runs are reproducible.
+ * The formulas added to the search tree (e.g., bounds in branch-and-bound) are kept across restarts.
+ *
+ * The Luby and geometric policies preserve completeness since the cutoff is unbounded, but the constant policy does not.
+ */
+class RestartController {
+  RestartPolicy policy;
+  long base;
+  double factor;
+  unsigned int seed;
+  int restarts;
+  size_t fails_at_restart;
+  long cutoff;
+
+  long cutoff_of(int i) const {
+    switch(policy) {
+      case RestartPolicy::CONSTANT: return base;
+      case RestartPolicy::GEOMETRIC: return static_cast<long>(std::ceil(base * std::pow(factor, i)));
+      case RestartPolicy::LUBY: return base * luby(i + 1);
+      default: return 0;
+    }
+  }
+
+public:
+  RestartController(RestartPolicy policy = RestartPolicy::NONE, long base = 100, double factor = 1.5, unsigned int seed = 0)
+   : policy(policy), base(base), factor(factor), seed(seed), restarts(0), fails_at_restart(0), cutoff(cutoff_of(0))
+  {
+    assert(base > 0);
+    assert(factor >= 1.0);
+  }
+
+  /** Restart `tree` if the number of fails since the last restart reached the current cutoff.
+   * \return `true` if `tree` was restarted. */
+  template <class Tree>
+  bool restart_if_needed(Tree& tree) {
+    if(policy == RestartPolicy::NONE || tree.num_fails() - fails_at_restart < static_cast<size_t>(cutoff)) {
+      return false;
+    }
+    if(!tree.restart()) {
+      return false;
+    }
+    fails_at_restart = tree.num_fails();
+    ++restarts;
+    cutoff = cutoff_of(restarts);
+    std::seed_seq seq{seed, static_cast<unsigned int>(restarts)};
+    std::mt19937 rng(seq);
+    tree.split->shuffle_random_strategies(rng);
+    return true;
+  }
+
+  int num_restarts() const {
+    return restarts;
+  }
+
+  /** The number of fails allowed before the next restart. */
+  long current_cutoff() const {
+    return cutoff;
+  }
+
+  RestartPolicy restart_policy() const {
+    return policy;
+  }
+};
+
+} // namespace lala
+
+#endif
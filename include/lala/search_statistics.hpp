@@ -0,0 +1,160 @@
+// Copyright 2025 Pierre Talbot
+
+#ifndef LALA_POWER_SEARCH_STATISTICS_HPP
+#define LALA_POWER_SEARCH_STATISTICS_HPP
+
+#include <cstdio>
+#include <cstdint>
+
+#ifndef __CUDA_ARCH__
+  #include <chrono>
+#endif
+
+#include "battery/utility.hpp"
+#include "battery/vector.hpp"
+
+namespace lala {
+
+/** Statistics of the exploration of a search tree, maintained by `SearchTree` and `BAB`.
+ * The statistics of several search trees (e.g., the workers of a parallel search) can be combined with `merge`.
+ * The timers rely on `std::chrono::steady_clock` and are only available on the host, on the device, they always remain at `0`.
+ */
+template <class Allocator = battery::standard_allocator>
+struct SearchStatistics {
+  using allocator_type = Allocator;
+
+  /** Number of nodes explored, not counting the root node. */
+  size_t nodes;
+  /** Number of nodes pruned because the sub-domain is `bot`. */
+  size_t fails;
+  /** Number of solutions found (updated by `BAB::deduce`). */
+  size_t solutions;
+  /** Number of times we backtracked to the next open node. */
+  size_t backtracks;
+  /** Number of decisions deduced when going from a snapshot (root or a node of the trail) to the next node to explore after backtracking, including the decision of that node. */
+  size_t replayed_deductions;
+  /** Number of restarts (see `SearchTree::restart`). */
+  size_t restarts;
+  /** Maximal depth reached. */
+  int max_depth;
+
+  /** When enabled (see `track_depths`), `nodes_per_depth[d]` is the number of nodes explored at depth `d + 1`. */
+  bool depth_histogram;
+  battery::vector<size_t, allocator_type> nodes_per_depth;
+
+  /** Time in nanoseconds since `start_timer`, at the end of the search (`stop_timer`), and when the last solution was found. */
+  int64_t search_time;
+  int64_t time_to_last_solution;
+  int64_t start_time;
+
+  CUDA SearchStatistics(const allocator_type& alloc = allocator_type())
+   : nodes(0), fails(0), solutions(0), backtracks(0), replayed_deductions(0), restarts(0), max_depth(0)
+   , depth_histogram(false), nodes_per_depth(alloc)
+   , search_time(0), time_to_last_solution(0), start_time(0)
+  {
+    start_timer();
+  }
+
+  SearchStatistics(const SearchStatistics&) = default;
+  SearchStatistics(SearchStatistics&&) = default;
+  SearchStatistics& operator=(const SearchStatistics&) = default;
+  SearchStatistics& operator=(SearchStatistics&&) = default;
+
+  template <class Alloc2>
+  CUDA SearchStatistics(const SearchStatistics<Alloc2>& other, const allocator_type& alloc = allocator_type())
+   : nodes(other.nodes), fails(other.fails), solutions(other.solutions), backtracks(other.backtracks)
+   , replayed_deductions(other.replayed_deductions), restarts(other.restarts), max_depth(other.max_depth)
+   , depth_histogram(other.depth_histogram), nodes_per_depth(other.nodes_per_depth, alloc)
+   , search_time(other.search_time), time_to_last_solution(other.time_to_last_solution), start_time(other.start_time)
+  {}
+
+  CUDA void track_depths(bool enable = true) {
+    depth_histogram = enable;
+  }
+
+  /** Record a new node at depth `depth` (the root node has a depth of `0`). */
+  CUDA void record_node(int depth) {
+    ++nodes;
+    max_depth = battery::max(max_depth, depth);
+    if(depth_histogram) {
+      while(nodes_per_depth.size() < depth) {
+        nodes_per_depth.push_back(0);
+      }
+      ++nodes_per_depth[depth - 1];
+    }
+  }
+
+  CUDA void record_solution() {
+    ++solutions;
+    time_to_last_solution = elapsed();
+  }
+
+  /** \return the number of nanoseconds since `start_timer` was called. */
+  CUDA int64_t elapsed() const {
+  #ifndef __CUDA_ARCH__
+    return now() - start_time;
+  #else
+    return 0;
+  #endif
+  }
+
+  CUDA void start_timer() {
+  #ifndef __CUDA_ARCH__
+    start_time = now();
+  #endif
+  }
+
+  CUDA void stop_timer() {
+    search_time = elapsed();
+  }
+
+  /** Combine the statistics of `other` into these statistics.
+   * The counters and histograms are summed, and we keep the maximum of the depths and times (the workers of a parallel search run concurrently). */
+  template <class Alloc2>
+  CUDA void merge(const SearchStatistics<Alloc2>& other) {
+    nodes += other.nodes;
+    fails += other.fails;
+    solutions += other.solutions;
+    backtracks += other.backtracks;
+    replayed_deductions += other.replayed_deductions;
+    restarts += other.restarts;
+    max_depth = battery::max(max_depth, other.max_depth);
+    depth_histogram |= other.depth_histogram;
+    while(nodes_per_depth.size() < other.nodes_per_depth.size()) {
+      nodes_per_depth.push_back(0);
+    }
+    for(int i = 0; i < other.nodes_per_depth.size(); ++i) {
+      nodes_per_depth[i] += other.nodes_per_depth[i];
+    }
+    search_time = battery::max(search_time, other.search_time);
+    time_to_last_solution = battery::max(time_to_last_solution, other.time_to_last_solution);
+  }
+
+  /** Print the statistics in the format of the MiniZinc statistics (one `%%%mzn-stat: name=value` per line). */
+  CUDA void print() const {
+    printf("%%%%%%mzn-stat: nodes=%zu\n", nodes);
+    printf("%%%%%%mzn-stat: failures=%zu\n", fails);
+    printf("%%%%%%mzn-stat: solutions=%zu\n", solutions);
+    printf("%%%%%%mzn-stat: backtracks=%zu\n", backtracks);
+    printf("%%%%%%mzn-stat: replayed_deductions=%zu\n", replayed_deductions);
+    printf("%%%%%%mzn-stat: restarts=%zu\n", restarts);
+    printf("%%%%%%mzn-stat: peakDepth=%d\n", max_depth);
+    printf("%%%%%%mzn-stat: solveTime=%.6f\n", search_time / 1e9);
+    printf("%%%%%%mzn-stat: time_to_last_solution=%.6f\n", time_to_last_solution / 1e9);
+    for(int i = 0; i < nodes_per_depth.size(); ++i) {
+      printf("%%%%%%mzn-stat: nodes_depth_%d=%zu\n", i + 1, nodes_per_depth[i]);
+    }
+  }
+
+private:
+#ifndef __CUDA_ARCH__
+  static int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+#endif
+};
+
+}
+
+#endif
@@ -11,8 +11,100 @@
 #include "lala/vstore.hpp"
 
 #include "split_strategy.hpp"
+#include "search_statistics.hpp"
+
+#include <optional>
+#include <cstring>
+#include <type_traits>
+
+#ifdef __CUDACC__
+  #include <cuda/std/atomic>
+#else
+  #include <atomic>
+#endif
 
 namespace lala {
+
+namespace impl {
+#ifdef __CUDACC__
+  namespace atomic_std = cuda::std;
+#else
+  namespace atomic_std = std;
+#endif
+}
+
+/** The order in which the nodes of the search tree are explored.
+ * - `DFS`: depth-first search, from left to right.
+ * - `LDS`: limited discrepancy search, in the iteration `k`, only the nodes with at most `k` discrepancies are explored (i.e., the path from root takes at most `k` times a branch that is not the left-most one).
+ * - `DDS`: depth-bounded discrepancy search, in the iteration `k`, discrepancies are only allowed at a depth smaller than `k`.
+ * The iterations of LDS and DDS start with `k = 0` and stop when no node was cut because of the discrepancy budget. */
+enum class TreeExploration {
+  DFS,
+  LDS,
+  DDS
+};
+
+inline const char* string_of_tree_exploration(TreeExploration exploration) {
+  switch(exploration) {
+    case TreeExploration::DFS: return "dfs";
+    case TreeExploration::LDS: return "lds";
+    case TreeExploration::DDS: return "dds";
+    default: return "unknown";
+  }
+}
+
+template <class StringType>
+std::optional<TreeExploration> tree_exploration_of_string(const StringType& str) {
+  if(str == "dfs") {
+    return TreeExploration::DFS;
+  }
+  else if(str == "lds") {
+    return TreeExploration::LDS;
+  }
+  else if(str == "dds") {
+    return TreeExploration::DDS;
+  }
+  else {
+    return std::nullopt;
+  }
+}
+
+/** The policy used to select the next node to explore when the current node is pruned.
+ * - `DFS`: the open nodes are kept in a stack, and the deepest one is explored next.
+ * - `BEST_FIRST`: on each backtrack, the open nodes of the stack are moved to a priority queue ordered by the bound of the objective variable in their parent node, and the most promising one is explored next (diving from it in depth-first order).
+ * - `HYBRID`: as `DFS`, but the open nodes are moved to the priority queue every `k` backtracks.
+ * When the priority queue contains too many nodes, the open nodes stay in the stack (i.e., we fall back to `DFS`) until it shrinks. */
+enum class FrontierPolicy {
+  DFS,
+  BEST_FIRST,
+  HYBRID
+};
+
+inline const char* string_of_frontier_policy(FrontierPolicy policy) {
+  switch(policy) {
+    case FrontierPolicy::DFS: return "dfs";
+    case FrontierPolicy::BEST_FIRST: return "best_first";
+    case FrontierPolicy::HYBRID: return "hybrid";
+    default: return "unknown";
+  }
+}
+
+template <class StringType>
+std::optional<FrontierPolicy> frontier_policy_of_string(const StringType& str) {
+  if(str == "dfs") {
+    return FrontierPolicy::DFS;
+  }
+  else if(str == "best_first") {
+    return FrontierPolicy::BEST_FIRST;
+  }
+  else if(str == "hybrid") {
+    return FrontierPolicy::HYBRID;
+  }
+  else {
+    return std::nullopt;
+  }
+}
+
 template <class A, class S, class Allocator> class SearchTree;
 namespace impl {
   template <class>
@@ -51,6 +143,12 @@ public:
   constexpr static const bool preserve_concrete_covers = sub_type::preserve_concrete_covers;
   constexpr static const char* name = "SearchTree";
 
+  /** `true` if the split strategy allocates the branches in a `NodeArena` (i.e., `branch_type::allocator_type` is an `arena_allocator`). */
+  constexpr static const bool arena_branches = requires(typename branch_type::allocator_type alloc) {
+    alloc.push_level();
+    alloc.pop_level();
+  };
+
   template <class Alloc>
   struct tell_type {
     typename A::template tell_type<Alloc> sub_tell;
@@ -78,6 +176,19 @@ public:
   template<class Alloc>
   using ask_type = typename A::template ask_type<Alloc>;
 
+  /** A sequence of decisions leading from the root node to another node of the search tree. */
+  using path_type = battery::vector<typename A::template tell_type<allocator_type>, allocator_type>;
+
+  /** The formulas told to a search tree, and given away with its subtrees (see `steal`). */
+  struct told_type {
+    battery::vector<typename A::template tell_type<allocator_type>, allocator_type> sub_tells;
+    battery::vector<typename split_type::template tell_type<allocator_type>, allocator_type> split_tells;
+    CUDA told_type(const allocator_type& alloc = allocator_type()): sub_tells(alloc), split_tells(alloc) {}
+    template <class ToldType>
+    CUDA told_type(const ToldType& other, const allocator_type& alloc)
+     : sub_tells(other.sub_tells, alloc), split_tells(other.split_tells, alloc) {}
+  };
+
 
   template <class A2, class S2, class Alloc2>
   friend class SearchTree;
@@ -93,17 +204,98 @@ private:
   using split_snapshot_type = split_type::template snapshot_type<allocator_type>;
   using root_type = battery::tuple<sub_snapshot_type, split_snapshot_type>;
   root_type root;
+  // Projection of the variables of the split strategy in the root node, updated whenever `root` is snapshotted.
+  // It is protected by a sequence lock so `project` can read it from another thread: the search (the only writer) makes `projection_seq` odd while it writes, and the readers retry when `projection_seq` changed during their copy, hence the search never waits for the readers.
+  // The universe of the variable `i` is stored in the words `[i * projection_words, (i + 1) * projection_words)`, which are only accessed with relaxed atomic operations.
+  // The buffer is only resized when the number of variables changes (i.e., before the search).
+  using projection_word = unsigned long long;
+  static constexpr int projection_words = (sizeof(local_universe) + sizeof(projection_word) - 1) / sizeof(projection_word);
+  mutable battery::vector<projection_word, allocator_type> root_projection;
+  impl::atomic_std::atomic<int> projection_vars;
+  impl::atomic_std::atomic<unsigned int> projection_seq;
+  // The shape of the search tree read by `project` (see `publish_shape`).
+  impl::atomic_std::atomic<int> shape;
+  static constexpr int BOT_SHAPE = 0;
+  static constexpr int SINGLETON_SHAPE = 1;
+  static constexpr int TREE_SHAPE = 2;
 
   // Tell formulas (and strategies) to be added to root on backtracking.
-  struct root_tell_type {
-    battery::vector<typename A::template tell_type<allocator_type>, allocator_type> sub_tells;
-    battery::vector<typename split_type::template tell_type<allocator_type>, allocator_type> split_tells;
-    CUDA root_tell_type(const allocator_type& alloc): sub_tells(alloc), split_tells(alloc) {}
-    template <class RootTellType>
-    CUDA root_tell_type(const RootTellType& other, const allocator_type& alloc)
-     : sub_tells(other.sub_tells, alloc), split_tells(other.split_tells, alloc) {}
-  };
+  using root_tell_type = told_type;
   root_tell_type root_tell;
+  // Formulas told to the search tree since it was last restored, whether they are already deduced in root or still pending in `root_tell` (see `steal`).
+  told_type told;
+
+  // The trail contains snapshots of some nodes along the current branch (by increasing depth), taken before committing to one of their children.
+  // The snapshot of the node at depth `0` is `root`, and is never in the trail.
+  struct level_snapshot {
+    int depth;
+    sub_snapshot_type sub_snap;
+    split_snapshot_type split_snap;
+    // Number of formulas in `root_tell` already deduced in this snapshot.
+    int num_root_tells;
+
+    CUDA level_snapshot(int depth, sub_snapshot_type&& sub_snap, split_snapshot_type&& split_snap, int num_root_tells)
+      : depth(depth)
+      , sub_snap(std::move(sub_snap))
+      , split_snap(std::move(split_snap))
+      , num_root_tells(num_root_tells)
+    {}
+
+    template <class LevelSnapshot>
+    CUDA level_snapshot(const LevelSnapshot& other, const allocator_type& alloc)
+      : depth(other.depth)
+      , sub_snap(other.sub_snap, alloc)
+      , split_snap(other.split_snap, alloc)
+      , num_root_tells(other.num_root_tells)
+    {}
+  };
+  battery::vector<level_snapshot, allocator_type> trail;
+  // A snapshot is taken every `snapshot_period` levels (`0` to only snapshot the root node).
+  int snapshot_period;
+  // In adaptive mode, snapshots are taken in the middle of the replayed paths longer than `snapshot_period`.
+  bool adaptive_snapshot;
+
+  SearchStatistics<allocator_type> stats;
+
+  TreeExploration exploration;
+  // Number of discrepancies allowed in the current iteration of LDS, or the depth until which discrepancies are allowed in DDS.
+  int discrepancy_budget;
+  // Number of discrepancies on the path from root to the current node.
+  int discrepancies;
+  // `true` if a node was not explored in the current iteration because of the discrepancy budget.
+  bool budget_exceeded;
+
+  // An open node of the frontier, represented by the decisions from root leading to it, and the bound of the objective variable in its parent.
+  struct frontier_node {
+    local_universe bound;
+    path_type path;
+
+    CUDA frontier_node(const local_universe& bound, path_type&& path)
+      : bound(bound), path(std::move(path))
+    {}
+
+    frontier_node(const frontier_node&) = default;
+    frontier_node(frontier_node&&) = default;
+    frontier_node& operator=(frontier_node&&) = default;
+
+    template <class FrontierNode>
+    CUDA frontier_node(const FrontierNode& other, const allocator_type& alloc)
+      : bound(other.bound), path(other.path, alloc)
+    {}
+  };
+
+  FrontierPolicy frontier_policy;
+  AVar objective;
+  bool minimize;
+  // Binary heap of the open nodes, the most promising node is `frontier[0]`.
+  battery::vector<frontier_node, allocator_type> frontier;
+  // The bound of the objective variable in the node of each branch of `stack` (only when `frontier_policy != DFS`).
+  battery::vector<local_universe, allocator_type> stack_bounds;
+  // Maximal number of nodes in `frontier`.
+  int max_frontier_size;
+  // In `HYBRID`, the open nodes are moved to the frontier every `frontier_period` backtracks.
+  int frontier_period;
+  int backtracks;
 
 public:
   CUDA SearchTree(AType uid, sub_ptr a, split_ptr split, const allocator_type& alloc = allocator_type())
@@ -112,9 +304,33 @@ public:
    , split(std::move(split))
    , stack(alloc)
    , root(battery::make_tuple(this->a->snapshot(alloc), this->split->snapshot(alloc)))
+   , root_projection(alloc)
+   , projection_vars(0)
+   , projection_seq(0)
+   , shape(SINGLETON_SHAPE)
    , root_tell(alloc)
-  {}
+   , told(alloc)
+   , trail(alloc)
+   , snapshot_period(0)
+   , adaptive_snapshot(false)
+   , stats(alloc)
+   , exploration(TreeExploration::DFS)
+   , discrepancy_budget(0)
+   , discrepancies(0)
+   , budget_exceeded(false)
+   , frontier_policy(FrontierPolicy::DFS)
+   , objective()
+   , minimize(true)
+   , frontier(alloc)
+   , stack_bounds(alloc)
+   , max_frontier_size(0)
+   , frontier_period(1)
+   , backtracks(0)
+  {
+    project_root();
+  }
 
+  /** When `arena_branches` is `true`, the branches of the copied stack and the split strategy of the copy still allocate in the arena of `other`, hence the copy and `other` must not be used concurrently (the parallel drivers reject such trees). */
   template<class A2, class S2, class Alloc2, class... Allocators>
   CUDA NI SearchTree(const SearchTree<A2, S2, Alloc2>& other, AbstractDeps<Allocators...>& deps)
    : atype(other.atype)
@@ -124,8 +340,31 @@ public:
    , root(
       sub_snapshot_type(battery::get<0>(other.root), deps.template get_allocator<allocator_type>()),
       split_snapshot_type(battery::get<1>(other.root), deps.template get_allocator<allocator_type>()))
+   , root_projection(other.root_projection, deps.template get_allocator<allocator_type>())
+   , projection_vars(other.projection_vars.load())
+   , projection_seq(0)
+   , shape(BOT_SHAPE)
    , root_tell(other.root_tell, deps.template get_allocator<allocator_type>())
-  {}
+   , told(other.told, deps.template get_allocator<allocator_type>())
+   , trail(other.trail, deps.template get_allocator<allocator_type>())
+   , snapshot_period(other.snapshot_period)
+   , adaptive_snapshot(other.adaptive_snapshot)
+   , stats(other.stats, deps.template get_allocator<allocator_type>())
+   , exploration(other.exploration)
+   , discrepancy_budget(other.discrepancy_budget)
+   , discrepancies(other.discrepancies)
+   , budget_exceeded(other.budget_exceeded)
+   , frontier_policy(other.frontier_policy)
+   , objective(other.objective)
+   , minimize(other.minimize)
+   , frontier(other.frontier, deps.template get_allocator<allocator_type>())
+   , stack_bounds(other.stack_bounds, deps.template get_allocator<allocator_type>())
+   , max_frontier_size(other.max_frontier_size)
+   , frontier_period(other.frontier_period)
+   , backtracks(other.backtracks)
+  {
+    publish_shape();
+  }
 
   CUDA AType aty() const {
     return atype;
@@ -136,7 +375,7 @@ public:
   }
 
   CUDA local::B is_singleton() const {
-    return stack.empty() && bool(a);
+    return stack.empty() && frontier.empty() && bool(a);
   }
 
   CUDA local::B is_top() const {
@@ -186,11 +425,182 @@ public:
     a = snap.sub;
     a->restore(snap.sub_snap);
     split->restore(snap.split_snap);
-    stack.clear();
-    root = battery::make_tuple(
-      a->snapshot(get_allocator()),
-      split->snapshot(get_allocator()));
+    clear_stack();
+    trail.clear();
+    frontier.clear();
+    snapshot_root();
     root_tell = root_tell_type(get_allocator());
+    told = told_type(get_allocator());
+    discrepancy_budget = 0;
+    discrepancies = 0;
+    budget_exceeded = false;
+    publish_shape();
+  }
+
+  /** Restore the search tree to `snap`, and deduce the decisions of `path` from there.
+   * The node obtained becomes the root of the search tree. */
+  template <class Alloc2, class Path>
+  CUDA local::B restore(const snapshot_type<Alloc2>& snap, const Path& path) {
+    restore(snap);
+    local::B has_changed = false;
+    for(int i = 0; i < path.size(); ++i) {
+      has_changed |= a->deduce(path[i]);
+    }
+    return has_changed;
+  }
+
+  /** Restore the search tree to `snap`, and deduce the formulas of `told` and the decisions of `path` from there (see `steal`).
+   * The node obtained becomes the root of the search tree. */
+  template <class Alloc2, class Told, class Path>
+  CUDA local::B restore(const snapshot_type<Alloc2>& snap, const Told& told, const Path& path) {
+    restore(snap);
+    local::B has_changed = false;
+    for(int i = 0; i < told.sub_tells.size(); ++i) {
+      has_changed |= a->deduce(told.sub_tells[i]);
+    }
+    for(int i = 0; i < told.split_tells.size(); ++i) {
+      has_changed |= split->deduce(told.split_tells[i]);
+    }
+    for(int i = 0; i < path.size(); ++i) {
+      has_changed |= a->deduce(path[i]);
+    }
+    return has_changed;
+  }
+
+  /** Give away the last unexplored child of the shallowest node having one, it is removed from this search tree.
+   * The formulas told to this search tree since it was last restored are added to `told`, whether they were already deduced in root or not (e.g., the bounds added by branch-and-bound, and the strategies added to the split strategy).
+   * The decisions leading from root to the child are added to `path`.
+   * Therefore, if this search tree was last restored with `restore(snap, told0, path0)`, `restore(snap, told0 + told, path0 + path)` on a copy of this search tree leads to the subtree given away.
+   * The formulas told before the first restoration (e.g., the problem itself) are in the log too, hence the search tree should be restored once before its first steal (see `WorkStealing`).
+   * The formulas told are kept until the next restoration, hence they are given to every thief, and not only the formulas told since the last steal.
+   * \return `false` if no node has an unexplored child. */
+  template <class Told, class Path>
+  CUDA bool steal(Told& told, Path& path) {
+    using decision_type = typename Path::value_type;
+    for(int i = 0; i < stack.size(); ++i) {
+      if(stack[i].has_next()) {
+        for(int j = 0; j < this->told.sub_tells.size(); ++j) {
+          told.sub_tells.push_back(this->told.sub_tells[j]);
+          told.split_tells.push_back(this->told.split_tells[j]);
+        }
+        for(int j = 0; j < i; ++j) {
+          path.push_back(decision_type(stack[j].current(), path.get_allocator()));
+        }
+        path.push_back(decision_type(stack[i].steal(), path.get_allocator()));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** Hybrid copying/recomputation: a snapshot of the nodes at depth `k * period` is kept along the current branch.
+   * On backtracking, we restore the nearest snapshot above the deepest node with an unexplored child, and only replay the decisions below it.
+   * With `period == 0`, only the root node is kept (full recomputation), and with `period == 1`, every node is kept (see `use_trail`).
+   * In adaptive mode, no snapshot is taken when going down the tree, instead, whenever we replay more than `period` decisions, we keep a snapshot of the node in the middle of the replayed path.
+   * Hence, snapshots are only kept where recomputation was observed to be expensive.
+   * \pre The search tree must be a singleton. */
+  CUDA void use_recomputation(int period, bool adaptive = false) {
+    assert(is_singleton() || is_bot());
+    assert(period >= 0);
+    snapshot_period = period;
+    adaptive_snapshot = adaptive;
+  }
+
+  /** In trail mode, we keep a snapshot of every node along the current branch.
+   * On backtracking, we restore the deepest node with an unexplored child and only deduce this child, instead of restoring the root node and replaying every decision from it.
+   * It trades memory (one snapshot per depth) for time, and the nodes restored do not need to be propagated again.
+   * \pre The search tree must be a singleton. */
+  CUDA void use_trail(bool enable = true) {
+    use_recomputation(enable ? 1 : 0);
+  }
+
+  CUDA int recomputation_period() const {
+    return snapshot_period;
+  }
+
+  CUDA bool is_adaptive_recomputation() const {
+    return adaptive_snapshot;
+  }
+
+  /** Set the order in which the search tree is explored (see `TreeExploration`).
+   * \pre The search tree must be a singleton. */
+  CUDA void use_exploration(TreeExploration mode) {
+    assert(is_singleton() || is_bot());
+    assert(mode == TreeExploration::DFS || frontier_policy == FrontierPolicy::DFS);
+    exploration = mode;
+    discrepancy_budget = 0;
+    discrepancies = 0;
+    budget_exceeded = false;
+  }
+
+  /** Select the next node to explore according to `policy` (see `FrontierPolicy`).
+   * The nodes in the priority queue are ordered by the bound of `objective` in their parent node: the smallest lower bound first if `minimize`, and the largest upper bound first otherwise.
+   * When used under `BAB`, `objective` and `minimize` are usually `bab.objective_var()` and `bab.is_minimization()`.
+   * \param max_size The maximal number of nodes in the priority queue, beyond which the open nodes stay in the stack.
+   * \param period In `HYBRID`, the open nodes are moved to the priority queue every `period` backtracks.
+   * \pre The search tree must be a singleton, and explored in depth-first order (see `use_exploration`). */
+  CUDA void use_frontier(FrontierPolicy policy, AVar objective, bool minimize, int max_size = 1000000, int period = 100) {
+    assert(is_singleton() || is_bot());
+    assert(policy == FrontierPolicy::DFS || exploration == TreeExploration::DFS);
+    assert(max_size >= 0 && period > 0);
+    frontier_policy = policy;
+    this->objective = objective;
+    this->minimize = minimize;
+    max_frontier_size = max_size;
+    frontier_period = period;
+    backtracks = 0;
+  }
+
+  CUDA FrontierPolicy frontier_policy_() const {
+    return frontier_policy;
+  }
+
+  /** \return the number of open nodes in the priority queue. */
+  CUDA int frontier_size() const {
+    return frontier.size();
+  }
+
+  /** \return the number of formulas added to the search tree with several nodes (see `deduce(t)`) that are not yet deduced in its root node. */
+  CUDA int num_pending_root_tells() const {
+    return root_tell.sub_tells.size();
+  }
+
+  CUDA TreeExploration tree_exploration() const {
+    return exploration;
+  }
+
+  /** The number of discrepancies on the path from root to the current node. */
+  CUDA int num_discrepancies() const {
+    return discrepancies;
+  }
+
+  /** The iteration of LDS or DDS, this is the number of discrepancies allowed in LDS, and the depth until which discrepancies are allowed in DDS. */
+  CUDA int discrepancy_iteration() const {
+    return discrepancy_budget;
+  }
+
+  CUDA bool is_budget_exceeded() const {
+    return budget_exceeded;
+  }
+
+  /** Restore the counters of the search, for instance when resuming the search from a checkpoint (see `checkpoint.hpp`). */
+  CUDA void restore_counters(size_t num_fails, int discrepancy_iteration, bool is_budget_exceeded) {
+    stats.fails = num_fails;
+    discrepancy_budget = discrepancy_iteration;
+    budget_exceeded = is_budget_exceeded;
+  }
+
+  /** In LDS and DDS, the nodes explored in an iteration are explored again in the next iteration.
+   * \return `true` if the current node was already explored in a previous iteration, this is useful to skip the solutions already found. */
+  CUDA bool is_revisited() const {
+    if(discrepancy_budget == 0) {
+      return false;
+    }
+    switch(exploration) {
+      case TreeExploration::LDS: return discrepancies < discrepancy_budget;
+      case TreeExploration::DDS: return stack.size() < size_t(discrepancy_budget) || stack[discrepancy_budget - 1].current_index() == 0;
+      default: return false;
+    }
   }
 
 public:
@@ -233,6 +643,8 @@ public:
   template <class Alloc>
   CUDA local::B deduce(const tell_type<Alloc>& t) {
     if(!is_bot()) {
+      told.sub_tells.push_back(t.sub_tell);
+      told.split_tells.push_back(t.split_tell);
       if(!is_singleton()) {
         // We will add `t` to root when we backtrack (see `pop`) and have a chance to modify the root node.
         root_tell.sub_tells.push_back(t.sub_tell);
@@ -250,7 +662,10 @@ public:
    * If we observe `a` from the outside of this domain, `a` can backtrack, and therefore does not always evolve extensively and monotonically.
    * Nevertheless, the deduction operator of the search tree abstract domain is extensive and monotonic (if split is) over the search tree. */
   CUDA bool deduce() {
-    return pop(push(split->split()));
+    push_branch_level();
+    bool has_changed = pop(push(split->split()));
+    publish_shape();
+    return has_changed;
   }
 
   template <class ExtractionStrategy = NonAtomicExtraction>
@@ -265,9 +680,12 @@ public:
     if constexpr(impl::is_search_tree_like<B>::value) {
       assert(bool(ua.a));
       a->extract(*ua.a);
-      ua.stack.clear();
+      ua.clear_stack();
+      ua.trail.clear();
+      ua.frontier.clear();
       ua.root_tell.sub_tells.clear();
       ua.root_tell.split_tells.clear();
+      ua.publish_shape();
     }
     else {
       a->extract(ua);
@@ -276,42 +694,38 @@ public:
 
   /** If the search tree is empty (\f$ \top \f$), we return \f$ \top_U \f$.
    * If the search tree consists of a single node \f$ \{a\} \f$, we return the projection of `x` in that node.
-   * Projection in a search tree with multiple nodes is currently not supported (assert false). */
+   * If the search tree has multiple nodes, we return the projection of `x` in the root node, which is cached when the root node is snapshotted (this is a sound over-approximation of the projection in the remaining nodes, but it does not include the formulas of `root_tell` that are not yet deduced in root).
+   * Only the variables of the split strategy (i.e., of abstract type `split->var_aty_()`) can be projected on a search tree with multiple nodes, otherwise we return \f$ \top_U \f$ (no information).
+   * The shape of the search tree and the cache are published atomically by the search, hence a monitor can call `project` from another thread while the search tree has multiple nodes or is empty: the cache is read under a sequence lock, the monitor retries its copy if the root node is snapshotted in the meantime, and the search never waits for it.
+   * However, the projection in a single node reads the sub-domain, so it must not be called concurrently with the propagation of the root node or the `deduce()` splitting it (the monitor would read an universe being modified).
+   * Similarly, the cache is resized when the number of variables changes, so `project` must not be called concurrently with the interpretation of new variables. */
   CUDA local_universe project(AVar x) const {
-    if(is_bot()) {
+    int s = shape.load(impl::atomic_std::memory_order_acquire);
+    if(s == BOT_SHAPE) {
       return local_universe::bot();
     }
+    else if(s == SINGLETON_SHAPE) {
+      return a->project(x);
+    }
+    else if(x.aty() == split->var_aty_()) {
+      return project_root_cache(x.vid());
+    }
     else {
-      if(is_singleton()) {
-        return a->project(x);
-      }
-      else {
-        assert(false);
-        return local_universe::top();
-        /** The problem with the method below is that we need to modify `a`, so project is not const anymore.
-         * That might be problematic to modify `a` for a projection if it is currently being refined...
-         * Perhaps need to copy `a` (inefficient), or request a projection in the snapshot directly. */
-        // a->restore(root);
-        // local_universe u = a->project(x);
-        // BInc has_changed = BInc::bot();
-        // replay(has_changed);
-        // return u;
-      }
+      return local_universe::top();
     }
   }
 
   template <class Univ>
   CUDA void project(AVar x, Univ& r) const {
-    if(is_bot()) {
+    int s = shape.load(impl::atomic_std::memory_order_acquire);
+    if(s == BOT_SHAPE) {
       return r.meet_bot();
     }
-    else {
-      if(is_singleton()) {
-        a->project(x, r);
-      }
-      else {
-        assert(false);
-      }
+    else if(s == SINGLETON_SHAPE) {
+      a->project(x, r);
+    }
+    else if(x.aty() == split->var_aty_()) {
+      r.meet(project_root_cache(x.vid()));
     }
   }
 
@@ -320,18 +734,90 @@ public:
     return stack.size();
   }
 
+  /** \return the branch at depth `depth` on the path from root to the current node, its `current_index()` is the child leading to the current node. */
+  CUDA const branch_type& branch_at(int depth) const {
+    return stack[depth];
+  }
+
+  /** Build the branch of the current node and commit to its child `idx`, as `deduce()` would do if the children before `idx` were explored and failed.
+   * It is used to go back to a node of which we only know the branches along its path (see `checkpoint.hpp`).
+   * When `decision` is given, the branch is built again from it on `x` (see `SplitStrategy::branch_of`), and only its first `size` children are kept, the other ones are considered explored elsewhere (see `steal`).
+   * Otherwise, the current node is split by the split strategy, which must produce a branch on `x` with exactly `size` children.
+   * \pre The current node must be propagated, as it is before calling `deduce()`.
+   * \return `false` if the branch obtained is not on `x` or does not have the expected number of children, in which case the search tree is unchanged. */
+  CUDA bool descend(int idx, int size, AVar x, const BranchDecision* decision = nullptr) {
+    assert(!is_bot() && idx >= 0 && idx < size);
+    push_branch_level();
+    branch_type branch = decision == nullptr ? split->split() : split->branch_of(x, *decision);
+    if(branch.var() != x || (decision == nullptr ? branch.size() != size : branch.size() < size)) {
+      pop_branch_level();
+      return false;
+    }
+    while(branch.size() > size) {
+      branch.steal();
+    }
+    push(std::move(branch));
+    for(int i = 0; i < idx; ++i) {
+      stack.back().next();
+    }
+    discrepancies += idx;
+    commit_left();
+    publish_shape();
+    return true;
+  }
+
+  /** \return the number of failed nodes encountered so far, a node is failed when it is pruned and the sub-domain is `bot`. */
+  CUDA size_t num_fails() const {
+    return stats.fails;
+  }
+
+  /** The statistics of the exploration of this search tree (the number of solutions is maintained by `BAB`). */
+  CUDA const SearchStatistics<allocator_type>& statistics() const {
+    return stats;
+  }
+
+  CUDA SearchStatistics<allocator_type>& statistics() {
+    return stats;
+  }
+
+  /** Go back to the root node and forget the nodes explored so far.
+   * The formulas added to the search tree during the search (e.g., the bounds added by branch-and-bound) are kept, and the split strategy is reset to the first variable.
+   * Unless the search tree is explored entirely between two restarts, the search is not complete anymore.
+   * \return `true` if the current node has changed. */
+  CUDA bool restart() {
+    if(is_bot() || (stack.empty() && frontier.empty())) {
+      return false;
+    }
+    clear_stack();
+    trail.clear();
+    frontier.clear();
+    discrepancies = 0;
+    restore_root();
+    split->reset();
+    ++stats.restarts;
+    publish_shape();
+    return true;
+  }
+
 // private:
   /** \return `true` if the current node is pruned, and `false` if a new branch was pushed. */
   CUDA bool push(branch_type&& branch) {
     if(branch.size() > 0) {
       if(is_singleton()) {
-        root = battery::make_tuple(
-          a->snapshot(get_allocator()),
-          split->snapshot(get_allocator()));
+        snapshot_root();
+        // The sub-domain is about to become the left child, `project` must use the projection of the root node from now on.
+        shape.store(TREE_SHAPE, impl::atomic_std::memory_order_release);
+      }
+      else if(!adaptive_snapshot && snapshot_period > 0 && stack.size() % snapshot_period == 0) {
+        push_snapshot(stack.size());
+      }
+      if(frontier_policy != FrontierPolicy::DFS) {
+        stack_bounds.push_back(a->project(objective));
       }
       stack.push_back(std::move(branch));
       return false;
     }
+    pop_branch_level();
     return true;
   }
 
@@ -341,6 +827,12 @@ public:
       return commit_left();
     }
     else {
+      if(a && a->is_bot()) {
+        ++stats.fails;
+        if(!stack.empty()) {
+          split->on_failure(stack.back().var(), stack.back().current_index());
+        }
+      }
       bool has_changed = backtrack();
       has_changed |= commit_right();
       return has_changed;
@@ -351,6 +843,7 @@ public:
    * If we are on the root node, we save a snapshot of root before committing to the left node. */
   CUDA bool commit_left() {
     assert(bool(a));
+    stats.record_node(stack.size());
     return a->deduce(stack.back().next());
   }
 
@@ -359,20 +852,64 @@ public:
     if(!stack.empty()) {
       assert(bool(a));
       stack.back().next();
+      ++discrepancies;
+      stats.record_node(stack.size());
       return replay();
     }
     return false;
   }
 
-  /** Goes from the current node to root. */
+  /** \return `true` if the next child of the deepest node can be explored, which depends on the discrepancy budget in LDS and DDS. */
+  CUDA bool can_commit_right() {
+    if(!stack.back().has_next()) {
+      return false;
+    }
+    if((exploration == TreeExploration::LDS && discrepancies >= discrepancy_budget)
+     ||(exploration == TreeExploration::DDS && stack.size() > size_t(discrepancy_budget)))
+    {
+      budget_exceeded = true;
+      return false;
+    }
+    return true;
+  }
+
+  /** Goes from the current node to the nearest node in the trail above the deepest node with an unexplored child, and to root if there is none.
+   * In LDS and DDS, if some nodes were not explored because of the discrepancy budget, the next iteration starts at root with a larger budget. */
   CUDA bool backtrack() {
-    while(!stack.empty() && !stack.back().has_next()) {
+    ++stats.backtracks;
+    if(frontier_policy != FrontierPolicy::DFS) {
+      ++backtracks;
+      if(frontier_policy == FrontierPolicy::BEST_FIRST || backtracks % frontier_period == 0) {
+        push_frontier();
+      }
+    }
+    while(!stack.empty() && !can_commit_right()) {
+      discrepancies -= stack.back().current_index();
       stack.pop_back();
+      pop_branch_level();
+      if(frontier_policy != FrontierPolicy::DFS) {
+        stack_bounds.pop_back();
+      }
     }
-    if(!stack.empty()) {
-      a->restore(battery::get<0>(root));
-      split->restore(battery::get<1>(root));
-      return deduce_root();
+    while(trail.size() > 0 && trail.back().depth >= stack.size()) {
+      trail.pop_back();
+    }
+    if(trail.size() > 0) {
+      return restore_trail();
+    }
+    else if(!stack.empty()) {
+      return restore_root();
+    }
+    else if(!frontier.empty()) {
+      pop_frontier();
+      return restore_root();
+    }
+    else if(a && budget_exceeded) {
+      ++discrepancy_budget;
+      budget_exceeded = false;
+      discrepancies = 0;
+      restore_root();
+      return true;
     }
     else if(a) {
       a = nullptr;
@@ -381,6 +918,96 @@ public:
     return false;
   }
 
+  /** \return `true` if the node `i` of the frontier is more promising than the node `j`. */
+  CUDA bool is_better(int i, int j) const {
+    return minimize
+      ? frontier[i].bound.lb().value() < frontier[j].bound.lb().value()
+      : frontier[i].bound.ub().value() > frontier[j].bound.ub().value();
+  }
+
+  CUDA void swap_frontier(int i, int j) {
+    frontier_node tmp(std::move(frontier[i]));
+    frontier[i] = std::move(frontier[j]);
+    frontier[j] = std::move(tmp);
+  }
+
+  /** Move the open nodes of the stack to the frontier, unless the frontier is full. */
+  CUDA void push_frontier() {
+    for(int i = 0; i < stack.size(); ++i) {
+      while(stack[i].has_next() && frontier.size() < size_t(max_frontier_size)) {
+        using decision_type = typename path_type::value_type;
+        path_type path(get_allocator());
+        for(int j = 0; j < i; ++j) {
+          path.push_back(decision_type(stack[j].current(), get_allocator()));
+        }
+        path.push_back(decision_type(stack[i].steal(), get_allocator()));
+        frontier.push_back(frontier_node(stack_bounds[i], std::move(path)));
+        // Sift-up the new node.
+        for(int k = frontier.size() - 1; k > 0 && is_better(k, (k - 1) / 2); k = (k - 1) / 2) {
+          swap_frontier(k, (k - 1) / 2);
+        }
+      }
+    }
+  }
+
+  /** Remove the most promising node from the frontier, and rebuild the stack with one branch per decision of its path.
+   * The last decision is not committed yet, this is done by `commit_right`. */
+  CUDA void pop_frontier() {
+    assert(stack.empty() && trail.empty());
+    swap_frontier(0, frontier.size() - 1);
+    frontier_node node(std::move(frontier.back()));
+    frontier.pop_back();
+    // Sift-down the root of the heap.
+    for(int k = 0, best = 0; ; k = best) {
+      int l = 2 * k + 1;
+      int r = l + 1;
+      if(l < frontier.size() && is_better(l, best)) { best = l; }
+      if(r < frontier.size() && is_better(r, best)) { best = r; }
+      if(best == k) { break; }
+      swap_frontier(k, best);
+    }
+    using child_type = typename branch_type::tell_type;
+    for(int i = 0; i < node.path.size(); ++i) {
+      push_branch_level();
+      battery::vector<child_type, typename branch_type::allocator_type> child(split->get_branch_allocator());
+      child.push_back(child_type(node.path[i], split->get_branch_allocator()));
+      stack.push_back(branch_type(std::move(child)));
+      stack_bounds.push_back(node.bound);
+      if(i + 1 < node.path.size()) {
+        stack.back().next();
+      }
+    }
+  }
+
+  /** When the branches are allocated in a `NodeArena` (see `arena_branches`), each branch of the stack owns a level of the arena.
+   * The level of a branch is pushed before splitting, and popped when the branch is removed from the stack or when the split is empty. */
+  CUDA void push_branch_level() {
+    if constexpr(arena_branches) {
+      split->get_branch_allocator().push_level();
+    }
+  }
+
+  CUDA void pop_branch_level() {
+    if constexpr(arena_branches) {
+      split->get_branch_allocator().pop_level();
+    }
+  }
+
+  CUDA void clear_stack() {
+    int n = stack.size();
+    stack.clear();
+    stack_bounds.clear();
+    for(int i = 0; i < n; ++i) {
+      pop_branch_level();
+    }
+  }
+
+  CUDA bool restore_root() {
+    a->restore(battery::get<0>(root));
+    split->restore(battery::get<1>(root));
+    return deduce_root();
+  }
+
   /** We do not always have access to the root node, so formulas that are added to the search tree are kept in `root_tell`.
    * During backtracking, root is available through `a`, and we add to root the formulas stored until now, so they become automatically available to the remaining nodes in the search tree. */
   CUDA bool deduce_root() {
@@ -395,19 +1022,120 @@ public:
       root_tell.sub_tells.clear();
       root_tell.split_tells.clear();
       // A new snapshot is necessary since we modified `a` and `split`.
-      root = battery::make_tuple(
+      snapshot_root();
+    }
+    return has_changed;
+  }
+
+  CUDA void snapshot_root() {
+    root = battery::make_tuple(
+      a->snapshot(get_allocator()),
+      split->snapshot(get_allocator()));
+    project_root();
+  }
+
+  /** Cache the projection of the variables in the current node, which must be the root node.
+   * The search is the only writer, and it never waits for the readers (see `project_root_cache`). */
+  CUDA NI void project_root() {
+    static_assert(std::is_trivially_copyable_v<local_universe>, "The projection of the root node is copied word by word.");
+    int n = a->vars();
+    projection_seq.fetch_add(1, impl::atomic_std::memory_order_relaxed);
+    impl::atomic_std::atomic_thread_fence(impl::atomic_std::memory_order_release);
+    if(root_projection.size() != n * projection_words) {
+      root_projection.resize(n * projection_words);
+    }
+    projection_vars.store(n, impl::atomic_std::memory_order_relaxed);
+    AType var_aty = split->var_aty_();
+    for(int i = 0; i < n; ++i) {
+      local_universe u = a->project(AVar(var_aty, i));
+      projection_word words[projection_words] = {};
+      memcpy(words, &u, sizeof(local_universe));
+      for(int k = 0; k < projection_words; ++k) {
+        impl::atomic_std::atomic_ref<projection_word>(root_projection[i * projection_words + k]).store(words[k], impl::atomic_std::memory_order_relaxed);
+      }
+    }
+    projection_seq.fetch_add(1, impl::atomic_std::memory_order_release);
+  }
+
+  /** Read the projection of the variable `vid` in the last cache of the root node published by `project_root`.
+   * The copy is retried when `project_root` wrote the cache in the meantime. */
+  CUDA local_universe project_root_cache(int vid) const {
+    projection_word words[projection_words];
+    while(true) {
+      unsigned int s = projection_seq.load(impl::atomic_std::memory_order_acquire);
+      if(s & 1) {
+        continue;
+      }
+      bool in_cache = vid < projection_vars.load(impl::atomic_std::memory_order_relaxed);
+      if(in_cache) {
+        for(int k = 0; k < projection_words; ++k) {
+          words[k] = impl::atomic_std::atomic_ref<projection_word>(root_projection[vid * projection_words + k]).load(impl::atomic_std::memory_order_relaxed);
+        }
+      }
+      impl::atomic_std::atomic_thread_fence(impl::atomic_std::memory_order_acquire);
+      if(projection_seq.load(impl::atomic_std::memory_order_relaxed) == s) {
+        if(!in_cache) {
+          return local_universe::top();
+        }
+        local_universe u = local_universe::top();
+        memcpy(&u, words, sizeof(local_universe));
+        return u;
+      }
+    }
+  }
+
+  /** Publish the shape of the search tree read by `project`, after the operations that might change it. */
+  CUDA void publish_shape() {
+    shape.store(is_bot() ? BOT_SHAPE : (is_singleton() ? SINGLETON_SHAPE : TREE_SHAPE), impl::atomic_std::memory_order_release);
+  }
+
+  /** Restore the last node of the trail, and deduce the formulas added to `root_tell` since its snapshot was taken. */
+  CUDA bool restore_trail() {
+    level_snapshot& level = trail.back();
+    a->restore(level.sub_snap);
+    split->restore(level.split_snap);
+    bool has_changed = false;
+    if(level.num_root_tells < root_tell.sub_tells.size()) {
+      for(int i = level.num_root_tells; i < root_tell.sub_tells.size(); ++i) {
+        has_changed |= a->deduce(root_tell.sub_tells[i]);
+        has_changed |= split->deduce(root_tell.split_tells[i]);
+      }
+      level = level_snapshot(
+        level.depth,
         a->snapshot(get_allocator()),
-        split->snapshot(get_allocator()));
+        split->snapshot(get_allocator()),
+        root_tell.sub_tells.size());
     }
     return has_changed;
   }
 
-  /** Goes from `root` to the new node to be explored. */
+  /** Add the current node, at depth `depth`, to the trail. */
+  CUDA void push_snapshot(int depth) {
+    trail.push_back(level_snapshot(
+      depth,
+      a->snapshot(get_allocator()),
+      split->snapshot(get_allocator()),
+      root_tell.sub_tells.size()));
+  }
+
+  /** Goes from the last node restored (`root` or the last node of the trail) to the new node to be explored. */
   CUDA bool replay() {
     bool has_changed = false;
-    for(int i = 0; i < stack.size(); ++i) {
+    int from = trail.empty() ? 0 : trail.back().depth;
+    int middle = adaptive_snapshot && stack.size() - from > snapshot_period
+      ? from + (stack.size() - from) / 2
+      : -1;
+    for(int i = from; i < stack.size(); ++i) {
+      if(i == middle && i > from) {
+        push_snapshot(i);
+      }
+      if(i + 1 == stack.size()) {
+        split->on_commit(stack[i].var(), stack[i].current_index());
+      }
       has_changed |= a->deduce(stack[i].current());
     }
+    stats.replayed_deductions += stack.size() - from;
+    split->on_replayed(stack.back().var());
     return has_changed;
   }
 };
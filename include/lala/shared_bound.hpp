@@ -0,0 +1,187 @@
+// Copyright 2025 Pierre Talbot
+
+#ifndef LALA_POWER_SHARED_BOUND_HPP
+#define LALA_POWER_SHARED_BOUND_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <climits>
+
+#include "lala/logic/logic.hpp"
+
+namespace lala {
+
+/** The best objective value and the best solution shared by several workers optimizing the same problem (e.g., one `BAB` per thread), over an integer objective.
+ * The best value is a single atomic integer tightened with a compare-and-swap, hence reading it costs one atomic load.
+ * The best solution (the bounds of each variable) is protected by a sequence lock: the writer makes the sequence number odd while it writes, and readers retry when the sequence number changed during their copy.
+ * Readers never block writers, and the writers only wait for each other when they improve the bound at the same time.
+ * See `SharedBoundClient` to connect a `BAB` to a shared bound.
+ *
+ * This is a host-only structure based on `std::atomic`.
+ */
+class SharedBound {
+  bool minimize;
+  int num_vars;
+  std::atomic<int64_t> best;
+  std::atomic<unsigned int> seq;
+  // The solution and its objective value, only modified while `seq` is odd.
+  std::atomic<int64_t> solution_value;
+  std::unique_ptr<std::atomic<int64_t>[]> lbs;
+  std::unique_ptr<std::atomic<int64_t>[]> ubs;
+
+  bool better(int64_t v, int64_t w) const {
+    return minimize ? v < w : v > w;
+  }
+
+  void lock() {
+    unsigned int s = seq.load(std::memory_order_relaxed);
+    while((s & 1) || !seq.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+      s = seq.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  void unlock() {
+    seq.fetch_add(1, std::memory_order_release);
+  }
+
+public:
+  /** \param num_vars The number of variables of the solutions. */
+  SharedBound(bool minimize, int num_vars)
+   : minimize(minimize), num_vars(num_vars)
+   , best(no_bound(minimize)), seq(0), solution_value(no_bound(minimize))
+   , lbs(new std::atomic<int64_t>[num_vars]), ubs(new std::atomic<int64_t>[num_vars])
+  {
+    for(int i = 0; i < num_vars; ++i) {
+      lbs[i].store(0, std::memory_order_relaxed);
+      ubs[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  SharedBound(const SharedBound&) = delete;
+  SharedBound& operator=(const SharedBound&) = delete;
+
+  /** The value of `bound()` when no solution was found. */
+  static int64_t no_bound(bool minimize) {
+    return minimize ? INT64_MAX : INT64_MIN;
+  }
+
+  bool is_minimization() const {
+    return minimize;
+  }
+
+  /** \return the best objective value found by any worker, or `no_bound(is_minimization())`. */
+  int64_t bound() const {
+    return best.load(std::memory_order_acquire);
+  }
+
+  bool has_bound() const {
+    return bound() != no_bound(minimize);
+  }
+
+  /** Tighten the best value with `v`.
+   * \return `true` if `v` is strictly better than the best value. */
+  bool offer(int64_t v) {
+    int64_t b = best.load(std::memory_order_relaxed);
+    while(better(v, b)) {
+      if(best.compare_exchange_weak(b, v, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** Tighten the best value with the objective `x` in the solution `sol`, and if it is better, store the bounds of the variables of `sol`.
+   * \return `true` if the solution is better than the best one. */
+  template <class Store>
+  bool publish(AVar x, const Store& sol) {
+    auto obj = sol.project(x);
+    int64_t v = minimize ? obj.lb().value() : obj.ub().value();
+    if(!offer(v)) {
+      return false;
+    }
+    lock();
+    // A better solution might have been written since we tightened `best`.
+    if(better(v, solution_value.load(std::memory_order_relaxed))) {
+      solution_value.store(v, std::memory_order_relaxed);
+      for(int i = 0; i < num_vars; ++i) {
+        auto u = sol.project(AVar{x.aty(), i});
+        lbs[i].store(u.lb().value(), std::memory_order_relaxed);
+        ubs[i].store(u.ub().value(), std::memory_order_relaxed);
+      }
+    }
+    unlock();
+    return true;
+  }
+
+  /** Copy the best solution in `lb` and `ub` (the bounds of each variable), and its objective value in `value`.
+   * \return `false` if there is no solution yet. */
+  bool read_solution(std::vector<int64_t>& lb, std::vector<int64_t>& ub, int64_t& value) const {
+    lb.resize(num_vars);
+    ub.resize(num_vars);
+    while(true) {
+      unsigned int s = seq.load(std::memory_order_acquire);
+      if(s & 1) {
+        continue;
+      }
+      value = solution_value.load(std::memory_order_relaxed);
+      for(int i = 0; i < num_vars; ++i) {
+        lb[i] = lbs[i].load(std::memory_order_relaxed);
+        ub[i] = ubs[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if(seq.load(std::memory_order_relaxed) == s) {
+        return value != no_bound(minimize);
+      }
+    }
+  }
+};
+
+/** Connect a `BAB` to a `SharedBound`: `publish` shares the solutions found by this `BAB`, and `poll` tightens its sub-domain with the bounds found by the other workers.
+ * `poll` is meant to be called at each node, and only costs an atomic load when the shared bound did not change since the last call.
+ * The shared bound is a single value, hence `BAB` must have a single objective (with several objectives, a solution improving only a later objective would be rejected by `SharedBound::offer`). */
+template <class BAB>
+class SharedBoundClient {
+  SharedBound& shared;
+  BAB& bab;
+  int64_t last_seen;
+
+public:
+  SharedBoundClient(SharedBound& shared, BAB& bab)
+   : shared(shared), bab(bab), last_seen(SharedBound::no_bound(shared.is_minimization()))
+  {
+    assert(bab.is_optimization());
+    assert(bab.num_objectives() == 1);
+    assert(bab.is_minimization() == shared.is_minimization());
+  }
+
+  /** Share the best solution of `bab`, usually called after `bab.deduce()`.
+   * \return `true` if it is better than the shared solution. */
+  bool publish() {
+    if(bab.solutions_count() == 0) {
+      return false;
+    }
+    return shared.publish(bab.objective_var(), bab.optimum());
+  }
+
+  /** Tighten the sub-domain of `bab` with the shared bound if it changed since the last call.
+   * \return `true` if the sub-domain was tightened. */
+  bool poll() {
+    int64_t v = shared.bound();
+    if(v == last_seen) {
+      return false;
+    }
+    last_seen = v;
+    using U = typename BAB::best_type::universe_type;
+    U u = U::top();
+    u.meet_lb(typename U::LB(static_cast<typename U::value_type>(v)));
+    u.meet_ub(typename U::UB(static_cast<typename U::value_type>(v)));
+    return bab.deduce(u);
+  }
+};
+
+} // namespace lala
+
+#endif
@@ -6,11 +6,14 @@
 #include "battery/vector.hpp"
 #include "battery/shared_ptr.hpp"
 #include "branch.hpp"
+#include "light_branch.hpp"
 #include "lala/logic/logic.hpp"
 #include "lala/b.hpp"
 #include "lala/abstract_deps.hpp"
 #include <optional>
 #include <algorithm>
+#include <type_traits>
+#include <cmath>
 
 namespace lala {
 
@@ -20,12 +23,14 @@ enum class VariableOrder {
   ANTI_FIRST_FAIL,
   SMALLEST,
   LARGEST,
-  RANDOM
+  RANDOM,
+  DOM_W_DEG,
+  ACTIVITY,
+  IMPACT
   // unsupported:
   // OCCURRENCE,
   // MOST_CONSTRAINED,
   // MAX_REGRET,
-  // DOM_W_DEG,
 };
 
 inline const char* string_of_variable_order(VariableOrder order) {
@@ -36,6 +41,9 @@ inline const char* string_of_variable_order(VariableOrder order) {
     case VariableOrder::SMALLEST: return "smallest";
     case VariableOrder::LARGEST: return "largest";
     case VariableOrder::RANDOM: return "random";
+    case VariableOrder::DOM_W_DEG: return "dom_w_deg";
+    case VariableOrder::ACTIVITY: return "activity";
+    case VariableOrder::IMPACT: return "impact";
     default: return "unknown";
   }
 }
@@ -60,6 +68,15 @@ std::optional<VariableOrder> variable_order_of_string(const StringType& str) {
   else if(str == "random") {
     return VariableOrder::RANDOM;
   }
+  else if(str == "dom_w_deg") {
+    return VariableOrder::DOM_W_DEG;
+  }
+  else if(str == "activity") {
+    return VariableOrder::ACTIVITY;
+  }
+  else if(str == "impact") {
+    return VariableOrder::IMPACT;
+  }
   else {
     return std::nullopt;
   }
@@ -71,6 +88,7 @@ enum class ValueOrder {
   MEDIAN,
   SPLIT,
   REVERSE_SPLIT,
+  SOLUTION,
   // unsupported:
   // INTERVAL,
   // RANDOM,
@@ -84,6 +102,7 @@ inline const char* string_of_value_order(ValueOrder order) {
     case ValueOrder::MEDIAN: return "median";
     case ValueOrder::SPLIT: return "split";
     case ValueOrder::REVERSE_SPLIT: return "reverse_split";
+    case ValueOrder::SOLUTION: return "solution";
     default: return "unknown";
   }
 }
@@ -105,6 +124,9 @@ std::optional<ValueOrder> value_order_of_string(const StringType& str) {
   else if(str == "reverse_split") {
     return ValueOrder::REVERSE_SPLIT;
   }
+  else if(str == "solution") {
+    return ValueOrder::SOLUTION;
+  }
   else {
     return std::nullopt;
   }
@@ -145,15 +167,20 @@ struct StrategyType {
   friend class StrategyType;
 };
 
-template <class A, class Allocator = typename A::allocator_type>
+/** `BranchAllocator` is the allocator of the branches created by `split` (the tells of the children and the vector containing them).
+ * Since a branch only lives while it is on the stack of the search tree, it can be an `arena_allocator` (see `node_arena.hpp`) to avoid a heap allocation per node. */
+template <class A, class Allocator = typename A::allocator_type, class BranchAllocator = Allocator>
 class SplitStrategy {
 public:
   using allocator_type = Allocator;
+  using branch_allocator_type = BranchAllocator;
   using sub_type = A;
   using sub_allocator_type = typename sub_type::allocator_type;
-  using sub_tell_type = sub_type::template tell_type<allocator_type>;
-  using branch_type = Branch<sub_tell_type, allocator_type>;
-  using this_type = SplitStrategy<sub_type, allocator_type>;
+  using sub_tell_type = sub_type::template tell_type<branch_allocator_type>;
+  using branch_type = Branch<sub_tell_type, branch_allocator_type>;
+  using local_universe = typename A::universe_type::local_type;
+  using light_branch_type = LightBranch<local_universe>;
+  using this_type = SplitStrategy<sub_type, allocator_type, branch_allocator_type>;
 
   constexpr static const bool is_abstract_universe = false;
   constexpr static const bool sequential = sub_type::sequential;
@@ -173,11 +200,17 @@ public:
     size_t num_strategies;
     int current_strategy;
     int next_unassigned_var;
+    size_t heap_trail_size;
+    int live_size;
+    int live_epoch;
 
-    CUDA snapshot_type(size_t num_strategies, int current_strategy, int next_unassigned_var)
+    CUDA snapshot_type(size_t num_strategies, int current_strategy, int next_unassigned_var, size_t heap_trail_size = 0, int live_size = -1, int live_epoch = -1)
       : num_strategies(num_strategies)
       , current_strategy(current_strategy)
       , next_unassigned_var(next_unassigned_var)
+      , heap_trail_size(heap_trail_size)
+      , live_size(live_size)
+      , live_epoch(live_epoch)
     {}
 
     snapshot_type(const snapshot_type<Alloc>&) = default;
@@ -190,13 +223,24 @@ public:
       : num_strategies(other.num_strategies)
       , current_strategy(other.current_strategy)
       , next_unassigned_var(other.next_unassigned_var)
+      , heap_trail_size(other.heap_trail_size)
+      , live_size(other.live_size)
+      , live_epoch(other.live_epoch)
     {}
   };
 
   template <class Alloc2>
   using tell_type = battery::vector<StrategyType<Alloc2>, Alloc2>;
 
-  template <class A2, class Alloc2>
+  /** `true` if the children of a branch can be built directly from the universe of the variable split, without interpreting a formula in the sub-domain.
+   * It requires the tell of the sub-domain to be a vector of elements constructible from `(AVar, local_universe)` (e.g., `VStore`), and the universe to be over integers. */
+  constexpr static const bool direct_tells =
+    std::is_integral_v<typename local_universe::value_type> &&
+    requires(AVar x, local_universe u, sub_tell_type t) {
+      t.push_back(typename sub_tell_type::value_type(x, u));
+    };
+
+  template <class A2, class Alloc2, class BranchAlloc2>
   friend class SplitStrategy;
 
 private:
@@ -210,47 +254,476 @@ private:
   battery::vector<StrategyType<allocator_type>, allocator_type> strategies;
   int current_strategy;
   int next_unassigned_var;
+  branch_allocator_type branch_alloc;
+  // `failures[i]` is the number of failed nodes of which the last decision was on the variable `i` (see `on_failure`).
+  battery::vector<int, allocator_type> failures;
+
+  // Priority index of the variables of the strategy `heap_strategy` (see `use_priority_index`), `-1` if there is none.
+  // `heap` is a binary min-heap of indices of variables in the strategy, ordered by `heap_keys`, and `heap_pos[i]` is the position of `i` in `heap` (`-1` if it is not in the heap).
+  // The keys are only refreshed when a variable reaches the top of the heap, and the modifications are recorded in `heap_trail` to be undone by `restore`.
+  using key_type = typename LB::value_type;
+  struct heap_undo {
+    // The index of the variable, or `-1` for the construction of the heap.
+    int i;
+    key_type key;
+  };
+  bool priority_index;
+  int heap_strategy;
+  battery::vector<int, allocator_type> heap;
+  battery::vector<int, allocator_type> heap_pos;
+  battery::vector<key_type, allocator_type> heap_keys;
+  battery::vector<heap_undo, allocator_type> heap_trail;
+
+  // Reversible sparse sets of the unassigned variables of each strategy, only used by the variable orders scanning all the variables (see `uses_live_set`).
+  // The first `live_size[s]` indices of `live_vars[s]` are the indices (in the variables of the strategy `s`) of the variables that might be unassigned, and the other ones are assigned.
+  // A variable is removed by swapping it with the last live variable, hence restoring `live_size[s]` on backtracking restores the removed variables.
+  // `live_size[s] == -1` means that all the variables must be considered live the next time the strategy `s` is used.
+  // Making all the variables live again reorders the sparse set, so the sizes saved before are not valid anymore, which is detected with `live_epoch[s]`, incremented each time.
+  battery::vector<battery::vector<int, allocator_type>, allocator_type> live_vars;
+  battery::vector<int, allocator_type> live_size;
+  battery::vector<int, allocator_type> live_epoch;
+
+  // Activity of the variables for `VariableOrder::ACTIVITY`, it is only maintained if a strategy uses this order.
+  // The bounds of the variables are recorded in `activity_lb` and `activity_ub` each time we split a node or the search tree replays a right child (see `on_replayed`), and compared to the bounds at the next split to find the variables that changed in between (due to the decisions and the deduction that followed).
+  // The recorded bounds are not valid when the last node was failed or restored (`activity_ref` is `false`), until the next split or replay.
+  bool track_activity;
+  bool activity_ref;
+  double activity_inc;
+  double activity_decay;
+  battery::vector<double, allocator_type> activity;
+  battery::vector<key_type, allocator_type> activity_lb;
+  battery::vector<key_type, allocator_type> activity_ub;
+
+  // Impacts of the decisions for `VariableOrder::IMPACT`, only maintained if a strategy uses this order.
+  // `impact[2*i + c]` is the average impact of the child `c` of the branches on the variable `i`, and `impact_count[2*i + c]` the number of measures.
+  // The impact of a decision is the reduction of the search space `1 - size_after / size_before`, or `1` if the decision fails.
+  // It is measured between the split of a node, or the parent of the right child replayed by the search tree (see `on_commit`), and the next split, on the child `impact_child` of the branch on `impact_var` (`impact_log_size` is the size of the node before the decision).
+  // `log_widths[i]` and `log_terms[i]` cache the width of the variable `i` and the logarithm of its domain size.
+  bool track_impact;
+  bool impact_ref;
+  AVar impact_var;
+  int impact_child;
+  double impact_log_size;
+  battery::vector<double, allocator_type> impact;
+  battery::vector<int, allocator_type> impact_count;
+  battery::vector<double, allocator_type> log_widths;
+  battery::vector<double, allocator_type> log_terms;
+
+  // The values of the variables in the last solution for `ValueOrder::SOLUTION` (see `save_phase`), and the value order used when a variable has no such value in its domain.
+  battery::vector<local_universe, allocator_type> phase;
+  ValueOrder phase_fallback;
 
   CUDA const battery::vector<AVar, allocator_type>& current_vars() const {
     return strategies[current_strategy].vars;
   }
 
+  /** The orders selecting the first unassigned variable (`INPUT_ORDER` and `RANDOM`) follow `next_unassigned_var`, the other ones use the live variables. */
+  CUDA static bool uses_live_set(VariableOrder order) {
+    return order != VariableOrder::INPUT_ORDER && order != VariableOrder::RANDOM;
+  }
+
+  CUDA bool is_assigned(const battery::vector<AVar, allocator_type>& vars, int i) const {
+    const auto& u = (*a)[vars.empty() ? i : vars[i].vid()];
+    return u.lb().value() == u.ub().value();
+  }
+
+  /** Make sure the live variables of the current strategy are initialized. */
+  CUDA NI void enter_live_set() {
+    int s = current_strategy;
+    while(live_size.size() <= s) {
+      live_vars.push_back(battery::vector<int, allocator_type>(get_allocator()));
+      live_size.push_back(-1);
+      live_epoch.push_back(0);
+    }
+    if(live_size[s] == -1) {
+      ++live_epoch[s];
+      int n = current_vars().empty() ? a->vars() : current_vars().size();
+      if(live_vars[s].size() != n) {
+        live_vars[s].clear();
+        for(int i = 0; i < n; ++i) {
+          live_vars[s].push_back(i);
+        }
+      }
+      live_size[s] = n;
+    }
+  }
+
+  /** Remove the live variable at position `p` in the current strategy. */
+  CUDA void remove_live(int p) {
+    auto& live = live_vars[current_strategy];
+    int last = --live_size[current_strategy];
+    int tmp = live[p];
+    live[p] = live[last];
+    live[last] = tmp;
+  }
+
+  CUDA void invalidate_live_sets() {
+    for(int s = 0; s < live_size.size(); ++s) {
+      live_size[s] = -1;
+    }
+  }
+
+  /** Move to the next strategy with an unassigned variable.
+   * For the strategies using the live variables, it is enough to remove the assigned variables at the end of the sparse set, until the last variable is unassigned. */
   CUDA NI void move_to_next_unassigned_var() {
     while(current_strategy < strategies.size()) {
       const auto& vars = current_vars();
-      int n = vars.empty() ? a->vars() : vars.size();
-      while(next_unassigned_var < n) {
-        universe_type v = (*a)[vars.empty() ? next_unassigned_var : vars[next_unassigned_var].vid()];
-        if(v.lb().value() != v.ub().value()) {
+      if(uses_live_set(strategies[current_strategy].var_order)) {
+        enter_live_set();
+        const auto& live = live_vars[current_strategy];
+        int& size = live_size[current_strategy];
+        while(size > 0 && is_assigned(vars, live[size - 1])) {
+          --size;
+        }
+        if(size > 0) {
           return;
         }
-        next_unassigned_var++;
+      }
+      else {
+        int n = vars.empty() ? a->vars() : vars.size();
+        while(next_unassigned_var < n) {
+          universe_type v = (*a)[vars.empty() ? next_unassigned_var : vars[next_unassigned_var].vid()];
+          if(v.lb().value() != v.ub().value()) {
+            return;
+          }
+          next_unassigned_var++;
+        }
       }
       current_strategy++;
       next_unassigned_var = 0;
+      if(current_strategy < live_size.size()) {
+        live_size[current_strategy] = -1;
+      }
+    }
+  }
+
+  /** Fold over the live variables of the current strategy, the assigned variables being removed on the way.
+   * \pre The last live variable is unassigned (see `move_to_next_unassigned_var`).
+   * \return the index of the best variable according to `better(i, best_i)`, which should break ties using the smallest index. */
+  template <class Better>
+  CUDA NI int live_fold(const battery::vector<AVar, allocator_type>& vars, Better better) {
+    const auto& live = live_vars[current_strategy];
+    int best_i = live[live_size[current_strategy] - 1];
+    // Going downward, the variable swapped with a removed one was already visited.
+    for(int p = live_size[current_strategy] - 2; p >= 0; --p) {
+      int i = live[p];
+      if(is_assigned(vars, i)) {
+        remove_live(p);
+      }
+      else if(better(i, best_i)) {
+        best_i = i;
+      }
     }
+    return best_i;
   }
 
   template <class MapFunction>
   CUDA NI AVar var_map_fold_left(const battery::vector<AVar, allocator_type>& vars, MapFunction op) {
-    int i = next_unassigned_var;
-    int best_i = i;
-    auto best = op((*a)[vars.empty() ? i : vars[i].vid()]);
+    int best_i = live_vars[current_strategy][live_size[current_strategy] - 1];
+    auto best = op((*a)[vars.empty() ? best_i : vars[best_i].vid()]);
+    best_i = live_fold(vars, [&](int i, int best_i) {
+      auto k = op((*a)[vars.empty() ? i : vars[i].vid()]);
+      if(best.meet(k)) {
+        return true;
+      }
+      return k == best && i < best_i;
+    });
+    return vars.empty() ? AVar{var_aty, best_i} : vars[best_i];
+  }
+
+  /** Select the variable with the smallest ratio between its width and its weight, the weight being `1 + failures[i]`.
+   * Since we do not have access to the constraints of the sub-domain, the weight of a variable is incremented when a decision on this variable leads to a failed node, rather than the weights of the constraints it occurs in. */
+  CUDA NI AVar select_dom_w_deg(const battery::vector<AVar, allocator_type>& vars) {
+    auto var_of = [&](int i) { return vars.empty() ? AVar{var_aty, i} : vars[i]; };
+    int best_i = live_vars[current_strategy][live_size[current_strategy] - 1];
+    double best = ratio_dom_w_deg(var_of(best_i));
+    best_i = live_fold(vars, [&](int i, int best_i) {
+      double r = ratio_dom_w_deg(var_of(i));
+      if(r < best || (r == best && i < best_i)) {
+        best = r;
+        return true;
+      }
+      return false;
+    });
+    return var_of(best_i);
+  }
+
+  /** Select the live variable with the highest activity. */
+  CUDA NI AVar select_activity(const battery::vector<AVar, allocator_type>& vars) {
+    auto vid_of = [&](int i) { return vars.empty() ? i : vars[i].vid(); };
+    int best_i = live_fold(vars, [&](int i, int best_i) {
+      double ai = activity_of(vid_of(i));
+      double abest = activity_of(vid_of(best_i));
+      return ai > abest || (ai == abest && i < best_i);
+    });
+    return vars.empty() ? AVar{var_aty, best_i} : vars[best_i];
+  }
+
+  CUDA double activity_of(int vid) const {
+    return vid < activity.size() ? activity[vid] : 0.0;
+  }
+
+  /** Increase the activity of the variable `vid`, all activities are rescaled when they become too large. */
+  CUDA void bump_activity(int vid) {
+    while(activity.size() <= vid) {
+      activity.push_back(0.0);
+    }
+    activity[vid] += activity_inc;
+    if(activity[vid] > 1e100) {
+      for(int i = 0; i < activity.size(); ++i) {
+        activity[i] *= 1e-100;
+      }
+      activity_inc *= 1e-100;
+    }
+  }
+
+  /** Increasing the bump, rather than decreasing all the activities, is equivalent to an exponential decay of the activities. */
+  CUDA void decay_activities() {
+    activity_inc /= activity_decay;
+  }
+
+  /** Record the bounds of the variables in the current node, the vectors are only reallocated when the number of variables changed. */
+  CUDA NI void record_activity_bounds() {
+    int n = a->vars();
+    if(activity_lb.size() != n) {
+      activity_lb.resize(n);
+      activity_ub.resize(n);
+    }
+    for(int i = 0; i < n; ++i) {
+      const auto& u = (*a)[i];
+      activity_lb[i] = u.lb().value();
+      activity_ub[i] = u.ub().value();
+    }
+    activity_ref = true;
+  }
+
+  /** Bump the variables that changed since the last split or restore, and record the current bounds in place. */
+  CUDA NI void update_activity() {
+    int n = a->vars();
+    if(!activity_ref || activity_lb.size() != n) {
+      record_activity_bounds();
+      return;
+    }
+    for(int i = 0; i < n; ++i) {
+      const auto& u = (*a)[i];
+      key_type lb = u.lb().value();
+      key_type ub = u.ub().value();
+      if(lb > activity_lb[i] || ub < activity_ub[i]) {
+        bump_activity(i);
+      }
+      activity_lb[i] = lb;
+      activity_ub[i] = ub;
+    }
+    decay_activities();
+  }
+
+  /** \return the logarithm of the size of the search space, i.e., the sum of the logarithms of the domain sizes of the variables.
+   * The logarithm of a domain size is only computed again when the width of the variable changed. */
+  CUDA NI double log_size() {
+    int n = a->vars();
+    if(log_widths.size() != n) {
+      log_widths.clear();
+      log_terms.clear();
+      for(int i = 0; i < n; ++i) {
+        log_widths.push_back(-1.0);
+        log_terms.push_back(0.0);
+      }
+    }
+    double size = 0;
+    for(int i = 0; i < n; ++i) {
+      const auto& u = (*a)[i];
+      double w = static_cast<double>(u.ub().value()) - static_cast<double>(u.lb().value());
+      if(w != log_widths[i]) {
+        log_widths[i] = w;
+        log_terms[i] = log(w + 1.0);
+      }
+      size += log_terms[i];
+    }
+    return size;
+  }
+
+  CUDA void record_impact(AVar x, int child, double value) {
+    if(x.is_untyped() || x.aty() != var_aty || child < 0 || child > 1) {
+      return;
+    }
+    int i = 2 * x.vid() + child;
+    while(impact.size() <= i) {
+      impact.push_back(0.0);
+      impact_count.push_back(0);
+    }
+    ++impact_count[i];
+    impact[i] += (value - impact[i]) / impact_count[i];
+  }
+
+  /** Measure the impact of the decision taken since the last split or replay (see `on_commit`). */
+  CUDA NI void update_impact() {
+    double size = log_size();
+    if(impact_ref) {
+      record_impact(impact_var, impact_child, 1.0 - exp(size - impact_log_size));
+    }
+    impact_log_size = size;
+    impact_ref = false;
+  }
+
+  /** \return the expected impact of splitting `x`, i.e., the sum of the impacts of its two children. */
+  CUDA double expected_impact(int vid) const {
+    return (2 * vid + 1 < impact.size()) ? impact[2 * vid] + impact[2 * vid + 1] : 0.0;
+  }
+
+  /** Select the live variable with the highest expected impact. */
+  CUDA NI AVar select_impact(const battery::vector<AVar, allocator_type>& vars) {
+    auto vid_of = [&](int i) { return vars.empty() ? i : vars[i].vid(); };
+    int best_i = live_fold(vars, [&](int i, int best_i) {
+      double ii = expected_impact(vid_of(i));
+      double ibest = expected_impact(vid_of(best_i));
+      return ii > ibest || (ii == ibest && i < best_i);
+    });
+    return vars.empty() ? AVar{var_aty, best_i} : vars[best_i];
+  }
+
+  CUDA double ratio_dom_w_deg(AVar x) const {
+    auto width = (*a)[x.vid()].width().ub();
+    double w = width.is_top() ? battery::limits<double>::inf() : static_cast<double>(width.value());
+    return w / weight(x);
+  }
+
+  /** The heap keys are such that the best variable has the smallest key.
+   * In a node, the key of a variable can only increase, it is what makes it possible to refresh the keys lazily. */
+  CUDA static key_type heap_key(const universe_type& u, VariableOrder order) {
+    switch(order) {
+      case VariableOrder::SMALLEST: return u.lb().value();
+      case VariableOrder::LARGEST: return -u.ub().value();
+      default: return -u.width().ub().value();
+    }
+  }
+
+  /** `FIRST_FAIL` is not indexable, see `use_priority_index`. */
+  CUDA static bool is_indexable(VariableOrder order) {
+    return order == VariableOrder::SMALLEST
+      || order == VariableOrder::LARGEST
+      || order == VariableOrder::ANTI_FIRST_FAIL;
+  }
+
+  CUDA bool heap_less(int i, int j) const {
+    return heap_keys[i] < heap_keys[j] || (heap_keys[i] == heap_keys[j] && i < j);
+  }
+
+  CUDA void heap_swap(int p, int q) {
+    int tmp = heap[p];
+    heap[p] = heap[q];
+    heap[q] = tmp;
+    heap_pos[heap[p]] = p;
+    heap_pos[heap[q]] = q;
+  }
+
+  CUDA void heap_sift_up(int p) {
+    for(; p > 0 && heap_less(heap[p], heap[(p - 1) / 2]); p = (p - 1) / 2) {
+      heap_swap(p, (p - 1) / 2);
+    }
+  }
+
+  CUDA void heap_sift_down(int p) {
+    for(int best = p; ; p = best) {
+      int l = 2 * p + 1;
+      int r = l + 1;
+      if(l < heap.size() && heap_less(heap[l], heap[best])) { best = l; }
+      if(r < heap.size() && heap_less(heap[r], heap[best])) { best = r; }
+      if(best == p) { break; }
+      heap_swap(p, best);
+    }
+  }
+
+  CUDA void heap_pop() {
+    heap_pos[heap[0]] = -1;
+    heap[0] = heap.back();
+    heap.pop_back();
+    if(heap.size() > 0) {
+      heap_pos[heap[0]] = 0;
+      heap_sift_down(0);
+    }
+  }
+
+  CUDA void heap_push(int i) {
+    heap.push_back(i);
+    heap_pos[i] = heap.size() - 1;
+    heap_sift_up(heap.size() - 1);
+  }
+
+  /** Build the heap of the unassigned variables of the current strategy in the current node. */
+  CUDA NI void build_heap(const battery::vector<AVar, allocator_type>& vars, VariableOrder order) {
+    heap_trail.push_back(heap_undo{-1, key_type{}});
+    heap_strategy = current_strategy;
     int n = vars.empty() ? a->vars() : vars.size();
-    for(++i; i < n; ++i) {
+    heap.clear();
+    heap_pos.clear();
+    heap_keys.clear();
+    for(int i = 0; i < n; ++i) {
+      const auto& u = (*a)[vars.empty() ? i : vars[i].vid()];
+      heap_keys.push_back(heap_key(u, order));
+      heap_pos.push_back(-1);
+      if(i >= next_unassigned_var && u.lb().value() != u.ub().value()) {
+        heap_pos[i] = heap.size();
+        heap.push_back(i);
+      }
+    }
+    for(int p = heap.size() / 2; p >= 0; --p) {
+      heap_sift_down(p);
+    }
+  }
+
+  /** Same as `var_map_fold_left` for the orders supported by the priority index, but in amortized logarithmic time in the number of variables.
+   * The top of the heap is removed if it is assigned, and its key is refreshed if its domain changed since it was inserted, until the key of the top is up-to-date. */
+  CUDA NI AVar select_indexed(const battery::vector<AVar, allocator_type>& vars, VariableOrder order) {
+    if(heap_strategy != current_strategy) {
+      build_heap(vars, order);
+    }
+    while(true) {
+      assert(heap.size() > 0);
+      int i = heap[0];
       const auto& u = (*a)[vars.empty() ? i : vars[i].vid()];
-      if(u.lb().value() != u.ub().value()) {
-        if(best.meet(op(u))) {
-          best_i = i;
+      if(u.lb().value() == u.ub().value()) {
+        heap_trail.push_back(heap_undo{i, heap_keys[i]});
+        heap_pop();
+        continue;
+      }
+      key_type k = heap_key(u, order);
+      if(k != heap_keys[i]) {
+        heap_trail.push_back(heap_undo{i, heap_keys[i]});
+        heap_keys[i] = k;
+        heap_sift_down(0);
+        continue;
+      }
+      return vars.empty() ? AVar{var_aty, i} : vars[i];
+    }
+  }
+
+  /** Undo the modifications of the heap until the trail has the size `n`.
+   * Undoing the construction of the heap removes the heap, and the older modifications are discarded. */
+  CUDA void restore_heap(size_t n) {
+    while(heap_trail.size() > n) {
+      heap_undo e = heap_trail.back();
+      heap_trail.pop_back();
+      if(e.i == -1) {
+        heap_strategy = -1;
+      }
+      else if(heap_strategy != -1) {
+        heap_keys[e.i] = e.key;
+        if(heap_pos[e.i] == -1) {
+          heap_push(e.i);
+        }
+        else {
+          heap_sift_up(heap_pos[e.i]);
         }
       }
     }
-    return vars.empty() ? AVar{var_aty, best_i} : vars[best_i];
   }
 
   CUDA AVar select_var() {
     const auto& strat = strategies[current_strategy];
     const auto& vars = strat.vars;
+    if(priority_index && is_indexable(strat.var_order)) {
+      return select_indexed(vars, strat.var_order);
+    }
     switch(strat.var_order) {
       case VariableOrder::RANDOM:
       case VariableOrder::INPUT_ORDER: return vars.empty() ? AVar{var_aty, next_unassigned_var} : vars[next_unassigned_var];
@@ -258,29 +731,71 @@ private:
       case VariableOrder::ANTI_FIRST_FAIL: return var_map_fold_left(vars, [](const universe_type& u) { return dual_bound<LB>(u.width().ub()); });
       case VariableOrder::LARGEST: return var_map_fold_left(vars, [](const universe_type& u) { return dual_bound<LB>(u.ub()); });
       case VariableOrder::SMALLEST: return var_map_fold_left(vars, [](const universe_type& u) { return dual_bound<UB>(u.lb()); });
+      case VariableOrder::DOM_W_DEG: return select_dom_w_deg(vars);
+      case VariableOrder::ACTIVITY: return select_activity(vars);
+      case VariableOrder::IMPACT: return select_impact(vars);
       default: printf("BUG: unsupported variable order strategy\n"); assert(false); return AVar{};
     }
   }
 
+  /** Meet `x op k` in the integer universe `u`.
+   * \return `false` if `op` is not supported. */
+  template <class K>
+  CUDA static bool meet_op(Sig op, const K& k, local_universe& u) {
+    using LB2 = typename local_universe::LB;
+    using UB2 = typename local_universe::UB;
+    switch(op) {
+      case EQ: u.meet_lb(LB2(k)); u.meet_ub(UB2(k)); return true;
+      case LEQ: u.meet_ub(UB2(k)); return true;
+      case LT: u.meet_ub(UB2(k - 1)); return true;
+      case GEQ: u.meet_lb(LB2(k)); return true;
+      case GT: u.meet_lb(LB2(k + 1)); return true;
+      default: return false;
+    }
+  }
+
+  /** Build the branch with the children `left` and `right`, its decision is recorded when `u` is an integer (see `BranchDecision`). */
+  template <class U>
+  CUDA branch_type make_binary_branch(AVar x, Sig left_op, Sig right_op, const U& u, sub_tell_type&& left, sub_tell_type&& right) {
+    battery::vector<sub_tell_type, branch_allocator_type> children({std::move(left), std::move(right)}, branch_alloc);
+    if constexpr(std::is_integral_v<std::remove_cvref_t<decltype(u.value())>>) {
+      return branch_type(std::move(children), x, BranchDecision{left_op, right_op, static_cast<int64_t>(u.value())});
+    }
+    else {
+      return branch_type(std::move(children), x);
+    }
+  }
+
   template <class U>
   CUDA NI branch_type make_branch(AVar x, Sig left_op, Sig right_op, const U& u) {
     if((u.is_top() && U::preserve_top) || (u.is_bot() && U::preserve_bot)) {
       if(u.is_top()) {
         printf("%% WARNING: Cannot currently branch on unbounded variables.\n");
       }
-      return branch_type(get_allocator());
+      return branch_type(branch_alloc);
+    }
+    if constexpr(direct_tells) {
+      local_universe l = local_universe::top();
+      local_universe r = local_universe::top();
+      if(x.aty() == a->aty() && meet_op(left_op, u.value(), l) && meet_op(right_op, u.value(), r)) {
+        using child_type = typename sub_tell_type::value_type;
+        sub_tell_type left(branch_alloc);
+        sub_tell_type right(branch_alloc);
+        left.push_back(child_type(x, l));
+        right.push_back(child_type(x, r));
+        return make_binary_branch(x, left_op, right_op, u, std::move(left), std::move(right));
+      }
     }
     using F = TFormula<allocator_type>;
-    using branch_vector = battery::vector<sub_tell_type, allocator_type>;
     VarEnv<allocator_type> empty_env{};
     auto k = u.template deinterpret<F>();
     IDiagnostics diagnostics;
-    sub_tell_type left(get_allocator());
-    sub_tell_type right(get_allocator());
+    sub_tell_type left(branch_alloc);
+    sub_tell_type right(branch_alloc);
     bool res = a->interpret_tell(F::make_binary(F::make_avar(x), left_op, k, x.aty(), get_allocator()), empty_env, left, diagnostics);
     res &= a->interpret_tell(F::make_binary(F::make_avar(x), right_op, k, x.aty(), get_allocator()), empty_env, right, diagnostics);
     if(res) {
-      return Branch(branch_vector({std::move(left), std::move(right)}, get_allocator()));
+      return make_binary_branch(x, left_op, right_op, u, std::move(left), std::move(right));
     }
     // Fallback on a more standard split search strategy.
     // We don't print anything because it might interfere with the output (without lock).
@@ -293,24 +808,157 @@ private:
       a->template interpret_tell<true>(F::make_binary(F::make_avar(x), left_op, k, x.aty(), get_allocator()), empty_env, left, diagnostics);
       a->template interpret_tell<true>(F::make_binary(F::make_avar(x), right_op, k, x.aty(), get_allocator()), empty_env, right, diagnostics);
       diagnostics.print();
-      return branch_type(get_allocator());
+      return branch_type(branch_alloc);
+    }
+  }
+
+  /** Similar to `make_branch` but the children are universes to be embedded in `x` instead of tells. */
+  template <class U>
+  CUDA NI light_branch_type make_light_branch(AVar x, Sig left_op, Sig right_op, const U& u) {
+    if((u.is_top() && U::preserve_top) || (u.is_bot() && U::preserve_bot)) {
+      if(u.is_top()) {
+        printf("%% WARNING: Cannot currently branch on unbounded variables.\n");
+      }
+      return light_branch_type();
+    }
+    if constexpr(std::is_integral_v<typename local_universe::value_type>) {
+      local_universe l = local_universe::top();
+      local_universe r = local_universe::top();
+      if(meet_op(left_op, u.value(), l) && meet_op(right_op, u.value(), r)) {
+        return light_branch_type(x, l, r);
+      }
+    }
+    using F = TFormula<allocator_type>;
+    VarEnv<allocator_type> empty_env{};
+    auto k = u.template deinterpret<F>();
+    IDiagnostics diagnostics;
+    local_universe left = local_universe::top();
+    local_universe right = local_universe::top();
+    bool res = local_universe::template interpret_tell<false>(F::make_binary(F::make_avar(x), left_op, k, x.aty(), get_allocator()), empty_env, left, diagnostics);
+    res &= local_universe::template interpret_tell<false>(F::make_binary(F::make_avar(x), right_op, k, x.aty(), get_allocator()), empty_env, right, diagnostics);
+    if(res) {
+      return light_branch_type(x, left, right);
+    }
+    else if(left_op != LEQ || right_op != GT) {
+      return make_light_branch(x, LEQ, GT, u);
+    }
+    else {
+      printf("%% WARNING: The universe does not support the underlying search strategy.\n");
+      return light_branch_type();
+    }
+  }
+
+  /** Build the branch on `x` according to the value order `order` with `make(x, left_op, right_op, value)`. */
+  template <class MakeBranch>
+  CUDA NI auto branch_on(AVar x, ValueOrder order, MakeBranch make) {
+    switch(order) {
+      case ValueOrder::MIN: return make(x, EQ, GT, a->project(x).lb());
+      case ValueOrder::MAX: return make(x, EQ, LT, a->project(x).ub());
+      // case ValueOrder::MEDIAN: return make(x, EQ, NEQ, a->project(x).median().lb());
+      case ValueOrder::SPLIT: return make(x, LEQ, GT, a->project(x).median().lb());
+      case ValueOrder::REVERSE_SPLIT: return make(x, GT, LEQ, a->project(x).median().lb());
+      case ValueOrder::SOLUTION: {
+        // We first try `x = v` when `v` is a bound of `x`, and otherwise we split the domain on `v` such that the left child contains `v`.
+        if(x.vid() < phase.size() && phase[x.vid()].lb().value() == phase[x.vid()].ub().value()) {
+          auto dom = a->project(x);
+          auto v = phase[x.vid()].lb();
+          if(dom.lb().value() == v.value()) { return make(x, EQ, GT, v); }
+          else if(dom.ub().value() == v.value()) { return make(x, EQ, LT, v); }
+          else if(dom.lb().value() < v.value() && v.value() < dom.ub().value()) { return make(x, LEQ, GT, v); }
+        }
+        return branch_on(x, phase_fallback, make);
+      }
+      default: printf("BUG: unsupported value order strategy\n"); assert(false); return make();
+    }
+  }
+
+  /** Select the next variable to split and its value, and build the branch with `make(x, left_op, right_op, value)`, or `make()` if no branch can be built. */
+  template <class MakeBranch>
+  CUDA NI auto split_with(MakeBranch make) {
+    if(a->is_bot()) {
+      activity_ref = false;
+      impact_ref = false;
+      return make();
+    }
+    if(track_activity) {
+      update_activity();
+    }
+    if(track_impact) {
+      update_impact();
+    }
+    move_to_next_unassigned_var();
+    if(current_strategy < strategies.size()) {
+      AVar x = select_var();
+      // printf("split on %d (", x.vid()); a->project(x).print(); printf(")\n");
+      if(track_impact) {
+        impact_ref = true;
+        impact_var = x;
+        impact_child = 0;
+      }
+      return branch_on(x, strategies[current_strategy].val_order, make);
+    }
+    else {
+      // printf("%% All variables are already assigned, we could not split anymore. It means the underlying abstract domain has not detected the satisfiability or unsatisfiability of the problem although all variables were assigned.\n");
+      return make();
     }
   }
 
 public:
-  CUDA SplitStrategy(AType atype, AType var_aty, abstract_ptr<A> a, const allocator_type& alloc = allocator_type()):
-    atype(atype), var_aty(var_aty), a(a), current_strategy(0), next_unassigned_var(0), strategies(alloc)
+  CUDA SplitStrategy(AType atype, AType var_aty, abstract_ptr<A> a, const allocator_type& alloc = allocator_type(), const branch_allocator_type& branch_alloc = branch_allocator_type()):
+    atype(atype), var_aty(var_aty), a(a), current_strategy(0), next_unassigned_var(0), strategies(alloc), branch_alloc(branch_alloc), failures(alloc),
+    priority_index(false), heap_strategy(-1), heap(alloc), heap_pos(alloc), heap_keys(alloc), heap_trail(alloc),
+    live_vars(alloc), live_size(alloc), live_epoch(alloc),
+    track_activity(false), activity_ref(false), activity_inc(1.0), activity_decay(0.95),
+    activity(alloc), activity_lb(alloc), activity_ub(alloc),
+    track_impact(false), impact_ref(false), impact_child(0), impact_log_size(0), impact(alloc), impact_count(alloc),
+    log_widths(alloc), log_terms(alloc),
+    phase(alloc), phase_fallback(ValueOrder::MIN)
   {}
 
-  template<class A2, class Alloc2, class... Allocators>
-  CUDA SplitStrategy(const SplitStrategy<A2, Alloc2>& other, AbstractDeps<Allocators...>& deps)
+  /** The branch allocator is copied from `other`: when it is an `arena_allocator`, the copy shares the same arena, and a new arena must be set with `set_branch_allocator` before both strategies are used concurrently.
+   * The parallel drivers (`WorkStealing`, `EPS` and `Portfolio`) copy their trees this way and statically reject arena allocated branches. */
+  template<class A2, class Alloc2, class BranchAlloc2, class... Allocators>
+  CUDA SplitStrategy(const SplitStrategy<A2, Alloc2, BranchAlloc2>& other, AbstractDeps<Allocators...>& deps)
    : atype(other.atype),
      var_aty(other.var_aty),
      a(deps.template clone<A>(other.a)),
      strategies(other.strategies, deps.template get_allocator<allocator_type>()),
      current_strategy(other.current_strategy),
-     next_unassigned_var(other.next_unassigned_var)
-  {}
+     next_unassigned_var(other.next_unassigned_var),
+     branch_alloc(other.branch_alloc),
+     failures(other.failures, deps.template get_allocator<allocator_type>()),
+     priority_index(other.priority_index),
+     heap_strategy(other.heap_strategy),
+     heap(other.heap, deps.template get_allocator<allocator_type>()),
+     heap_pos(other.heap_pos, deps.template get_allocator<allocator_type>()),
+     heap_keys(other.heap_keys, deps.template get_allocator<allocator_type>()),
+     heap_trail(deps.template get_allocator<allocator_type>()),
+     live_vars(other.live_vars, deps.template get_allocator<allocator_type>()),
+     live_size(other.live_size, deps.template get_allocator<allocator_type>()),
+     live_epoch(other.live_epoch, deps.template get_allocator<allocator_type>()),
+     track_activity(other.track_activity),
+     activity_ref(other.activity_ref),
+     activity_inc(other.activity_inc),
+     activity_decay(other.activity_decay),
+     activity(other.activity, deps.template get_allocator<allocator_type>()),
+     activity_lb(other.activity_lb, deps.template get_allocator<allocator_type>()),
+     activity_ub(other.activity_ub, deps.template get_allocator<allocator_type>()),
+     track_impact(other.track_impact),
+     impact_ref(other.impact_ref),
+     impact_var(other.impact_var),
+     impact_child(other.impact_child),
+     impact_log_size(other.impact_log_size),
+     impact(other.impact, deps.template get_allocator<allocator_type>()),
+     impact_count(other.impact_count, deps.template get_allocator<allocator_type>()),
+     log_widths(deps.template get_allocator<allocator_type>()),
+     log_terms(deps.template get_allocator<allocator_type>()),
+     phase(other.phase, deps.template get_allocator<allocator_type>()),
+     phase_fallback(other.phase_fallback)
+  {
+    for(int i = 0; i < other.heap_trail.size(); ++i) {
+      heap_trail.push_back(heap_undo{other.heap_trail[i].i, other.heap_trail[i].key});
+    }
+  }
 
   CUDA AType aty() const {
     return atype;
@@ -320,9 +968,19 @@ public:
     return strategies.get_allocator();
   }
 
+  CUDA branch_allocator_type get_branch_allocator() const {
+    return branch_alloc;
+  }
+
+  CUDA void set_branch_allocator(const branch_allocator_type& alloc) {
+    branch_alloc = alloc;
+  }
+
   template <class Alloc2 = allocator_type>
   CUDA snapshot_type<Alloc2> snapshot(const Alloc2& alloc = Alloc2()) const {
-    return snapshot_type<Alloc2>{strategies.size(), current_strategy, next_unassigned_var};
+    return snapshot_type<Alloc2>{strategies.size(), current_strategy, next_unassigned_var, heap_trail.size(),
+      current_strategy < live_size.size() ? live_size[current_strategy] : -1,
+      current_strategy < live_size.size() ? live_epoch[current_strategy] : -1};
   }
 
   template <class Alloc2 = allocator_type>
@@ -330,14 +988,173 @@ public:
     while(strategies.size() > snap.num_strategies) {
       strategies.pop_back();
     }
+    while(live_size.size() > snap.num_strategies) {
+      live_size.pop_back();
+      live_vars.pop_back();
+      live_epoch.pop_back();
+    }
+    restore_heap(snap.heap_trail_size);
+    // The restored node is usually not the node explored next, which is reached by replaying decisions (see `on_replayed`).
+    activity_ref = false;
+    impact_ref = false;
     current_strategy = snap.current_strategy;
     next_unassigned_var = snap.next_unassigned_var;
+    if(current_strategy < live_size.size()) {
+      live_size[current_strategy] = snap.live_epoch == live_epoch[current_strategy] ? snap.live_size : -1;
+    }
+  }
+
+  /** Called by the search tree when it replays the decisions leading to the child `child` of the branch on `x` (after a backtrack), just before deducing this child in the parent node.
+   * The impact of this child is measured from the size of the parent node to the next split.
+   * With recomputation, the parent node is not propagated yet, so the impact also counts the propagation of the decisions replayed before.
+   * Without this call, the decisions taken after a restore are not measured. */
+  CUDA NI void on_commit(AVar x, int child) {
+    if(track_impact) {
+      impact_ref = true;
+      impact_var = x;
+      impact_child = child;
+      impact_log_size = log_size();
+    }
+  }
+
+  /** Called by the search tree once it replayed the decisions leading to the child committed on the branch of `x` (after a backtrack), before this node is propagated.
+   * The bounds of the node obtained are the reference of the activities at the next split, hence the decisions replayed are not counted as changes, and only the decision on `x` bumps its activity.
+   * The propagation of the node still counts the deductions of the replayed decisions that were not propagated yet (e.g., from root with full recomputation).
+   * Without this call, the bounds are recorded at the next split, and the node is not counted. */
+  CUDA NI void on_replayed(AVar x) {
+    if(track_activity) {
+      record_activity_bounds();
+      if(!x.is_untyped() && x.aty() == var_aty) {
+        bump_activity(x.vid());
+      }
+    }
+  }
+
+  /** Record that a decision on `x` (the child `child` of its branch) led to a failed node, it increases the weight of `x` in `DOM_W_DEG`.
+   * This is called by the search tree on each failed node, with the variable of the branch of this node, and the weights are kept across restarts (`reset` and `restore` do not modify them). */
+  CUDA void on_failure(AVar x, int child = 0) {
+    if(x.is_untyped() || x.aty() != var_aty) {
+      return;
+    }
+    if(track_impact) {
+      record_impact(x, child, 1.0);
+    }
+    while(failures.size() <= x.vid()) {
+      failures.push_back(0);
+    }
+    ++failures[x.vid()];
+    if(track_activity) {
+      bump_activity(x.vid());
+      decay_activities();
+    }
+  }
+
+  /** \return the activity of `x` in `ACTIVITY`: each time the domain of `x` changes between two splits, or a decision on `x` fails, its activity increases by an amount that grows by a factor `1/decay` after each update (thus the activities decay exponentially). */
+  CUDA double activity_of(AVar x) const {
+    return activity_of(x.vid());
+  }
+
+  /** \return the average impact of the child `child` (`0` or `1`) of the branches on `x` in `IMPACT`, `0` if it was never measured. */
+  CUDA double impact_of(AVar x, int child) const {
+    int i = 2 * x.vid() + child;
+    return i < impact.size() ? impact[i] : 0.0;
+  }
+
+  /** Initialize the impacts by trying each child of the branch of each unassigned variable of the strategies in the current node (usually the root node).
+   * `propagate()` must compute the deduction of the sub-domain after a decision (e.g., the fixpoint of the propagators), the sub-domain is restored after each probe.
+   * Probing the variables is useful when they have no impact yet, otherwise the first variables would be selected in input order. */
+  template <class Propagate>
+  CUDA NI void probe_impacts(Propagate propagate) {
+    if(a->is_bot()) {
+      return;
+    }
+    auto snap = a->snapshot(get_allocator());
+    double size = log_size();
+    battery::vector<char, allocator_type> probed(get_allocator());
+    for(int s = 0; s < strategies.size(); ++s) {
+      const auto& vars = strategies[s].vars;
+      int n = vars.empty() ? a->vars() : vars.size();
+      for(int i = 0; i < n; ++i) {
+        AVar x = vars.empty() ? AVar{var_aty, i} : vars[i];
+        while(probed.size() <= x.vid()) {
+          probed.push_back(0);
+        }
+        if(probed[x.vid()] || is_assigned(vars, i)) {
+          continue;
+        }
+        probed[x.vid()] = 1;
+        branch_type branch = branch_on(x, strategies[s].val_order, [&](auto... args) {
+          if constexpr(sizeof...(args) == 0) {
+            return branch_type(branch_alloc);
+          }
+          else {
+            return make_branch(args...);
+          }
+        });
+        for(int c = 0; c < branch.size(); ++c) {
+          a->deduce(branch[c]);
+          propagate();
+          record_impact(x, c, a->is_bot() ? 1.0 : 1.0 - exp(log_size() - size));
+          a->restore(snap);
+        }
+      }
+    }
+  }
+
+  /** Set the decay factor of the activities, in `]0, 1]`, a smaller factor favors the recent activity (default `0.95`). */
+  CUDA void set_activity_decay(double decay) {
+    assert(decay > 0 && decay <= 1);
+    activity_decay = decay;
+  }
+
+  /** \return the weight of `x` in `DOM_W_DEG`, which is `1` plus the number of failures recorded on `x`. */
+  CUDA int weight(AVar x) const {
+    return 1 + (x.vid() < failures.size() ? failures[x.vid()] : 0);
+  }
+
+  /** Save the values of the variables in the solution `sol` (e.g., the best solution of `BAB`), the strategies with the value order `SOLUTION` first try these values.
+   * `sol` must be a store over the variables of the sub-domain, the variables that are not assigned in `sol` use the fallback value order (see `set_phase_fallback`). */
+  template <class Store>
+  CUDA NI void save_phase(const Store& sol) {
+    phase.clear();
+    for(int i = 0; i < a->vars(); ++i) {
+      phase.push_back(local_universe(sol.project(AVar{var_aty, i})));
+    }
+  }
+
+  /** Set the value order used by `SOLUTION` when a variable has no saved value or when this value is not in its domain (`MIN` by default). */
+  CUDA void set_phase_fallback(ValueOrder order) {
+    assert(order != ValueOrder::SOLUTION);
+    phase_fallback = order;
+  }
+
+  /** Share the weights of `DOM_W_DEG` of two split strategies (e.g., of two workers in parallel search), the weight of each variable becomes the maximum of both.
+   * The weights are not synchronized, so `other` must not be modified concurrently. */
+  template <class SplitStrategy2>
+  CUDA void merge_weights(const SplitStrategy2& other) {
+    while(failures.size() < other.failures.size()) {
+      failures.push_back(0);
+    }
+    for(int i = 0; i < other.failures.size(); ++i) {
+      failures[i] = battery::max(failures[i], other.failures[i]);
+    }
+  }
+
+  /** Select the variables of the orders `SMALLEST`, `LARGEST` and `ANTI_FIRST_FAIL` with a priority index (a binary heap) instead of scanning all the variables on each split.
+   * The heap is built the first time a strategy is used, and it is then maintained incrementally, its modifications being undone by `restore`.
+   * It does not support `FIRST_FAIL` because the key of a variable (its width) decreases in a node, so a variable might need to move up in the heap although it is not on its top, and the propagation does not tell us which variables changed.
+   * Hence, `FIRST_FAIL` is only served by the live variables of the strategy: it still scans the unassigned variables on each split, but the assigned variables are removed from the scan along the branch.
+   * The selected variables are the same as without the index. */
+  CUDA void use_priority_index(bool enable = true) {
+    priority_index = enable;
+    restore_heap(0);
   }
 
   /** Restart the search from the first variable. */
   CUDA void reset() {
     current_strategy = 0;
     next_unassigned_var = 0;
+    invalidate_live_sets();
   }
 
   /** This interpretation function expects `f` to be a predicate of the form `search(VariableOrder, ValueOrder, x_1, x_2, ..., x_n)`. */
@@ -360,6 +1177,9 @@ public:
     else if(var_order_str == "smallest") { strat.var_order = VariableOrder::SMALLEST; }
     else if(var_order_str == "largest") { strat.var_order = VariableOrder::LARGEST; }
     else if(var_order_str == "random") { strat.var_order = VariableOrder::RANDOM; }
+    else if(var_order_str == "dom_w_deg") { strat.var_order = VariableOrder::DOM_W_DEG; }
+    else if(var_order_str == "activity") { strat.var_order = VariableOrder::ACTIVITY; }
+    else if(var_order_str == "impact") { strat.var_order = VariableOrder::IMPACT; }
     else {
       RETURN_INTERPRETATION_ERROR("This variable order strategy is unsupported.");
     }
@@ -371,6 +1191,7 @@ public:
     }
     else if(val_order_str == "indomain_split") { strat.val_order = ValueOrder::SPLIT; }
     else if(val_order_str == "indomain_reverse_split") { strat.val_order = ValueOrder::REVERSE_SPLIT; }
+    else if(val_order_str == "indomain_solution") { strat.val_order = ValueOrder::SOLUTION; }
     else {
       RETURN_INTERPRETATION_ERROR("This value order strategy is unsupported.");
     }
@@ -409,6 +1230,8 @@ public:
     local::B has_changed = false;
     for(int i = 0; i < t.size(); ++i) {
       strategies.push_back(t[i]);
+      track_activity |= t[i].var_order == VariableOrder::ACTIVITY;
+      track_impact |= t[i].var_order == VariableOrder::IMPACT;
       has_changed = true;
     }
     return has_changed;
@@ -421,28 +1244,42 @@ public:
    If the next unassigned variable cannot be split, for instance because the value ordering strategy maps to `bot` or `top`, an empty set of branches is returned.
    This also means that you cannot suppose `split(a) = {}` to mean `a` is at `bot`. */
   CUDA NI branch_type split() {
-    if(a->is_bot()) {
-      return branch_type(get_allocator());
-    }
-    move_to_next_unassigned_var();
-    if(current_strategy < strategies.size()) {
-      AVar x = select_var();
-      // printf("split on %d (", x.vid()); a->project(x).print(); printf(")\n");
-      switch(strategies[current_strategy].val_order) {
-        case ValueOrder::MIN: return make_branch(x, EQ, GT, a->project(x).lb());
-        case ValueOrder::MAX: return make_branch(x, EQ, LT, a->project(x).ub());
-        // case ValueOrder::MEDIAN: return make_branch(x, EQ, NEQ, a->project(x).median().lb());
-        case ValueOrder::SPLIT: return make_branch(x, LEQ, GT, a->project(x).median().lb());
-        case ValueOrder::REVERSE_SPLIT: return make_branch(x, GT, LEQ, a->project(x).median().lb());
-        default: printf("BUG: unsupported value order strategy\n"); assert(false); return branch_type(get_allocator());
+    return split_with([&](auto... args) {
+      if constexpr(sizeof...(args) == 0) {
+        return branch_type(branch_alloc);
       }
+      else {
+        return make_branch(args...);
+      }
+    });
+  }
+
+  /** Build the branch of `decision` on `x` in the current node, as `split()` built it in the same node (see `Branch::decision`).
+   * The variable and value orders are not used, hence the branch does not depend on the state learned by the strategies since then (e.g., the weights of `DOM_W_DEG` or the last solution of `SOLUTION`).
+   * The branch is empty if the universe of the variables is not over integers. */
+  CUDA NI branch_type branch_of(AVar x, const BranchDecision& decision) {
+    using value_type = typename local_universe::value_type;
+    if constexpr(std::is_integral_v<value_type>) {
+      return make_branch(x, decision.left_op, decision.right_op, typename local_universe::LB(static_cast<value_type>(decision.value)));
     }
     else {
-      // printf("%% All variables are already assigned, we could not split anymore. It means the underlying abstract domain has not detected the satisfiability or unsatisfiability of the problem although all variables were assigned.\n");
-      return branch_type(get_allocator());
+      return branch_type(branch_alloc);
     }
   }
 
+  /** Same as `split` but the branch is a `LightBranch` with two universes to be embedded in the variable split (see `LightSearchTree`).
+   * The branch is empty (`size() == 0`) if no variable can be split. */
+  CUDA NI light_branch_type split_light() {
+    return split_with([&](auto... args) {
+      if constexpr(sizeof...(args) == 0) {
+        return light_branch_type();
+      }
+      else {
+        return make_light_branch(args...);
+      }
+    });
+  }
+
   CUDA size_t num_strategies() const {
     return strategies.size();
   }
@@ -454,17 +1291,34 @@ public:
     }
     battery::vector<AVar, allocator_type> vars(strategies.get_allocator());
     strategies[0] = StrategyType<allocator_type>(var_order, val_order, std::move(vars));
+    invalidate_live_sets();
   }
 
   CUDA void skip_eps_strategy() {
     current_strategy = std::max(1, current_strategy);
     next_unassigned_var = 0;
+    invalidate_live_sets();
   }
 
   CUDA const auto& strategies_() const {
     return strategies;
   }
 
+  /** \return the abstract type of the variables on which we split. */
+  CUDA AType var_aty_() const {
+    return var_aty;
+  }
+
+  /** Replace the variables of the `i`-th strategy by `vars`, for instance to restore the order of a `RANDOM` strategy shuffled in a previous search. */
+  template <class Vars>
+  CUDA void reorder_strategy(int i, const Vars& vars) {
+    strategies[i].vars.clear();
+    for(int j = 0; j < vars.size(); ++j) {
+      strategies[i].vars.push_back(vars[j]);
+    }
+    invalidate_live_sets();
+  }
+
   template<typename URBG>
   void shuffle_random_strategies(URBG& g) {
     for(int i = 0; i < strategies.size(); ++i) {
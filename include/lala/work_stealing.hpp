@@ -0,0 +1,198 @@
+// Copyright 2025 Pierre Talbot
+
+#ifndef LALA_POWER_WORK_STEALING_HPP
+#define LALA_POWER_WORK_STEALING_HPP
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include "battery/vector.hpp"
+#include "lala/abstract_deps.hpp"
+#include "search_tree.hpp"
+
+namespace lala {
+
+/** A multi-threaded driver exploring a search tree with work stealing.
+ * Each worker owns a copy of the search tree (usually obtained with the `AbstractDeps` copy constructor), and all copies must be at the same root node when the driver is created.
+ * Initially, only the first worker explores the search tree.
+ * An idle worker steals the last unexplored child of the shallowest node of a busy worker, which is the largest subtree available.
+ * The stolen subtree is represented by the formulas told to the victim (e.g., the bounds of branch-and-bound) and the path of decisions from the root node, hence the idle worker restores its root node and deduces them before exploring the subtree.
+ * The propagation of the nodes and the processing of the solutions are not done by this driver but in the `step` function given to `run`.
+ *
+ * This is a host-only driver based on `std::thread`.
+ */
+template <class Tree>
+class WorkStealing {
+public:
+  using tree_type = Tree;
+  using tree_ptr = abstract_ptr<tree_type>;
+  using allocator_type = typename tree_type::allocator_type;
+  using path_type = typename tree_type::path_type;
+  using told_type = typename tree_type::told_type;
+  using snapshot_type = typename tree_type::template snapshot_type<allocator_type>;
+
+  static_assert(!tree_type::arena_branches, "The trees of the workers are copies of one another, and the copies would share the `NodeArena` of their branches, which is not thread-safe.");
+
+private:
+  struct worker_type {
+    tree_ptr tree;
+    // Snapshot of the root node shared by all workers.
+    snapshot_type root;
+    // The formulas told and the decisions leading from `root` to the root of `tree`.
+    told_type told;
+    path_type path;
+    // `lock` protects `tree`, `told` and `path`.
+    std::mutex lock;
+    std::atomic<bool> busy;
+    // Number of workers waiting for `lock` to steal a subtree, the owner of `tree` yields until they are served.
+    std::atomic<int> thieves;
+
+    worker_type(tree_ptr tree)
+     : tree(tree)
+     , root(tree->snapshot(tree->get_allocator()))
+     , told(tree->get_allocator())
+     , path(tree->get_allocator())
+     , busy(false)
+     , thieves(0)
+    {
+      // The formulas told before `root` was taken are forgotten, so they are not given again to the thieves (see `SearchTree::steal`).
+      tree->restore(root);
+    }
+  };
+
+  std::vector<std::unique_ptr<worker_type>> workers;
+  std::atomic<int> idle_workers;
+  std::atomic<bool> stop_flag;
+  std::atomic<int> steals;
+
+public:
+  /** \pre Each tree must be a singleton and represent the same root node. */
+  WorkStealing(const std::vector<tree_ptr>& trees)
+   : idle_workers(0), stop_flag(false), steals(0)
+  {
+    assert(trees.size() > 0);
+    for(int i = 0; i < trees.size(); ++i) {
+      assert(trees[i]->is_singleton());
+      workers.push_back(std::make_unique<worker_type>(trees[i]));
+    }
+  }
+
+  int num_workers() const {
+    return workers.size();
+  }
+
+  tree_type& tree(int worker) {
+    return *workers[worker]->tree;
+  }
+
+  /** The number of subtrees that were stolen during the last call to `run`. */
+  int num_steals() const {
+    return steals;
+  }
+
+  /** \return the statistics of the search trees of all workers merged together. */
+  SearchStatistics<allocator_type> statistics() const {
+    SearchStatistics<allocator_type> stats(workers[0]->tree->statistics());
+    for(int i = 1; i < num_workers(); ++i) {
+      stats.merge(workers[i]->tree->statistics());
+    }
+    return stats;
+  }
+
+  /** Request all workers to stop, it can be called from `step`. */
+  void stop() {
+    stop_flag = true;
+  }
+
+  bool is_stopped() const {
+    return stop_flag;
+  }
+
+  /** Explore the search tree in parallel until it is empty or `stop()` is called.
+   * `step(int worker, tree_type& tree)` performs one iteration of the search on the tree of `worker`: propagating the current node, processing a solution if any, and calling `tree.deduce()`.
+   * If `step` returns `false`, all workers are stopped.
+   * `step` is never called concurrently on the same tree, but it is called concurrently on different trees.
+   * \return `true` if the whole search tree was explored, `false` if the search was stopped before. */
+  template <class Step>
+  bool run(Step step) {
+    int n = num_workers();
+    idle_workers = n - 1;
+    stop_flag = false;
+    steals = 0;
+    std::vector<std::thread> threads;
+    for(int i = 1; i < n; ++i) {
+      threads.emplace_back([&, i]() { work(i, false, step); });
+    }
+    work(0, true, step);
+    for(int i = 0; i < threads.size(); ++i) {
+      threads[i].join();
+    }
+    return !stop_flag;
+  }
+
+private:
+  template <class Step>
+  void work(int i, bool busy, Step& step) {
+    worker_type& w = *workers[i];
+    w.busy = busy;
+    while(!stop_flag) {
+      if(w.busy) {
+        while(w.thieves > 0) {
+          std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> guard(w.lock);
+        if(!step(i, *w.tree)) {
+          stop_flag = true;
+        }
+        if(w.tree->is_bot()) {
+          w.busy = false;
+          idle_workers++;
+        }
+      }
+      else if(idle_workers == num_workers()) {
+        break;
+      }
+      else if(steal(i)) {
+        w.busy = true;
+      }
+      else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  /** Try to steal a subtree from a busy worker, starting with the next one.
+   * The number of idle workers is decreased while the victim is locked, so it never reaches `num_workers()` while a subtree is being transferred. */
+  bool steal(int i) {
+    worker_type& thief = *workers[i];
+    for(int k = 1; k < num_workers(); ++k) {
+      worker_type& victim = *workers[(i + k) % num_workers()];
+      if(!victim.busy) {
+        continue;
+      }
+      victim.thieves++;
+      std::unique_lock<std::mutex> guard(victim.lock);
+      victim.thieves--;
+      told_type told(victim.told, thief.tree->get_allocator());
+      path_type path(victim.path, thief.tree->get_allocator());
+      if(!victim.tree->is_bot() && victim.tree->steal(told, path)) {
+        idle_workers--;
+        steals++;
+        guard.unlock();
+        std::lock_guard<std::mutex> thief_guard(thief.lock);
+        thief.told = std::move(told);
+        thief.path = std::move(path);
+        thief.tree->restore(thief.root, thief.told, thief.path);
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+} // namespace lala
+
+#endif
@@ -7,6 +7,10 @@
 using ST = SearchTree<IStore, SplitStrategy<IStore>>;
 using BAB_ = BAB<ST, IStore>;
 
+// The bound of the objective is added directly to a store, the other domains go through the interpretation of formulas.
+static_assert(BAB_::direct_bound);
+static_assert(!BAB<SearchTree<IPC, SplitStrategy<IPC>>, IStore>::direct_bound);
+
 template <class A>
 void check_solution(A& a, vector<Itv> solution) {
   for(int i = 0; i < solution.size(); ++i) {
@@ -113,6 +117,7 @@ void test_constrained_bab(bool mode) {
     has_changed |= search_tree->deduce();
   }
   EXPECT_TRUE(bab.is_bot());
+  EXPECT_EQ(search_tree->statistics().solutions, bab.solutions_count());
   if(mode) {
     check_solution(*best, {Itv(0,0),Itv(0,0),Itv(0,0)});
     EXPECT_EQ(iterations, 5);
@@ -139,3 +144,133 @@ TEST(BABTest, ConstrainedOptimization) {
   test_constrained_bab(true);
   test_constrained_bab(false);
 }
+
+void test_frontier_bab(FrontierPolicy policy, int max_size) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..4] of var 0..3: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    constraint int_le(a[3], a[4]);\
+    solve::int_search(a, input_order, indomain_min, complete) maximize a[3];");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  const size_t num_vars = 4;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), num_vars);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+  auto best = make_shared<IStore, standard_allocator>(store->aty(), num_vars);
+  auto bab = IBAB(env.extends_abstract_dom(), search_tree, best);
+
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, bab, diagnostics));
+  search_tree->use_frontier(policy, bab.objective_var(), bab.is_minimization(), max_size, 2);
+
+  local::B has_changed{true};
+  while(!bab.is_extractable() && has_changed) {
+    has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipc->num_deductions(),
+      [&](size_t i) { return ipc->deduce(i); },
+      has_changed
+    );
+    if(search_tree->is_extractable()) {
+      has_changed |= bab.deduce();
+    }
+    has_changed |= search_tree->deduce();
+  }
+  EXPECT_TRUE(bab.is_extractable());
+  EXPECT_EQ(bab.optimum().project(AVar(sty, 2)), Itv(3, 3));
+  EXPECT_EQ(search_tree->frontier_size(), 0);
+}
+
+TEST(BABTest, FrontierOptimization) {
+  test_frontier_bab(FrontierPolicy::DFS, 0);
+  test_frontier_bab(FrontierPolicy::BEST_FIRST, 1000);
+  test_frontier_bab(FrontierPolicy::HYBRID, 1000);
+  // The frontier is limited to a few nodes, and we fall back to depth-first search when it is full.
+  test_frontier_bab(FrontierPolicy::BEST_FIRST, 2);
+}
+
+TEST(BABTest, LexicographicOptimization) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..3] of var 0..2: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    solve::int_search(a, input_order, indomain_min, complete) maximize a[3];");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  const size_t num_vars = 3;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), num_vars);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+  auto best = make_shared<IStore, standard_allocator>(store->aty(), num_vars);
+  auto bab = IBAB(env.extends_abstract_dom(), search_tree, best);
+
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, bab, diagnostics));
+  // The second objective is optimized among the optimal solutions of the first one.
+  EXPECT_TRUE(bab.deduce(IBAB::tell_type<standard_allocator>(AVar(sty, 0), false)));
+  EXPECT_EQ(bab.num_objectives(), 2);
+  EXPECT_EQ(bab.objective_var(1), AVar(sty, 0));
+
+  // The lexicographic ordering is deduced by the propagators, so every solution reached is better than the previous one.
+  local::B has_changed{true};
+  while(!bab.is_extractable() && has_changed) {
+    has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipc->num_deductions(),
+      [&](size_t i) { return ipc->deduce(i); },
+      has_changed
+    );
+    if(search_tree->is_extractable()) {
+      EXPECT_TRUE(bab.deduce());
+      EXPECT_TRUE(bab.is_lexicographic_bound_deduced());
+      has_changed = true;
+    }
+    has_changed |= search_tree->deduce();
+  }
+  EXPECT_TRUE(bab.is_extractable());
+  check_solution(bab.optimum(), {Itv(2,2),Itv(0,0),Itv(2,2)});
+}
+
+TEST(BABTest, LexicographicOptimizationWithoutDisjunction) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..3] of var 0..2: a;\
+    solve::int_search(a, input_order, indomain_min, complete) maximize a[3];");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  const size_t num_vars = 3;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), num_vars);
+  auto split = make_shared<SplitStrategy<IStore>, standard_allocator>(env.extends_abstract_dom(), store->aty(), store);
+  auto search_tree = make_shared<ST, standard_allocator>(env.extends_abstract_dom(), store, split);
+  auto best = make_shared<IStore, standard_allocator>(store->aty(), num_vars);
+  auto bab = BAB_(env.extends_abstract_dom(), search_tree, best);
+
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, bab, diagnostics));
+  EXPECT_TRUE(bab.deduce(BAB_::tell_type<standard_allocator>(AVar(sty, 1), true)));
+
+  // A store cannot interpret the lexicographic ordering, only `a[3] >= v` prunes the search tree, and `deduce()` rejects the solutions that are not better.
+  auto all_assigned = [&]() {
+    for(int i = 0; i < num_vars; ++i) {
+      if((*store)[i].lb() != (*store)[i].ub()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  int rejected = 0;
+  while(!search_tree->is_bot()) {
+    if(search_tree->is_extractable() && all_assigned()) {
+      rejected += !bab.deduce();
+    }
+    search_tree->deduce();
+  }
+  EXPECT_FALSE(bab.is_lexicographic_bound_deduced());
+  EXPECT_GT(rejected, 0);
+  EXPECT_TRUE(bab.is_extractable());
+  check_solution(bab.optimum(), {Itv(0,0),Itv(0,0),Itv(2,2)});
+}
@@ -0,0 +1,179 @@
+// Copyright 2025 Pierre Talbot
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "lala/search_tree.hpp"
+#include "lala/bab.hpp"
+#include "lala/checkpoint.hpp"
+#include "helper.hpp"
+
+using IST = SearchTree<IPC, SplitStrategy<IPC>>;
+using IBAB = BAB<IST, IStore>;
+
+bool all_assigned(const IStore& a) {
+  for(int i = 0; i < a.vars(); ++i) {
+    if(a[i].lb() != a[i].ub()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct Model {
+  VarEnv<standard_allocator> env;
+  abstract_ptr<IStore> store;
+  abstract_ptr<IPC> ipc;
+  abstract_ptr<IST> search_tree;
+  abstract_ptr<IStore> best;
+  abstract_ptr<IBAB> bab;
+
+  Model(const std::string& fzn, int num_vars) {
+    SolverOutput<standard_allocator> output(standard_allocator{});
+    lala::impl::FlatZincParser<standard_allocator> parser(output);
+    auto f = parser.parse(fzn);
+    EXPECT_TRUE(f);
+    store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), num_vars);
+    ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+    auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+    search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+    best = make_shared<IStore, standard_allocator>(store->aty(), num_vars);
+    bab = make_shared<IBAB, standard_allocator>(env.extends_abstract_dom(), search_tree, best);
+    IDiagnostics diagnostics;
+    EXPECT_TRUE(interpret_and_tell<true>(*f, env, *bab, diagnostics));
+  }
+
+  bool propagate() {
+    local::B has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipc->num_deductions(),
+      [&](size_t i) { return ipc->deduce(i); },
+      has_changed
+    );
+    return !ipc->is_bot();
+  }
+
+  /** Perform at most `steps` steps of search, or until the search is finished if `steps` is negative. */
+  int solve(int steps) {
+    int solutions = 0;
+    while(!search_tree->is_bot() && steps-- != 0) {
+      propagate();
+      if(all_assigned(*store) && search_tree->is_extractable()
+        && (bab->is_satisfaction() || bab->solutions_count() == 0 || bab->compare_bound(*store, *best)))
+      {
+        bab->deduce();
+        ++solutions;
+      }
+      search_tree->deduce();
+    }
+    return solutions;
+  }
+};
+
+/** A checkpoint file in the temporary directory, unique to the current test so tests can run in parallel (`ctest -j`), and removed at the end of the test. */
+struct TempCheckpoint {
+  std::string path;
+
+  TempCheckpoint() {
+    const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::string name = std::string("lala_") + info->test_suite_name() + "_" + info->name() + ".bin";
+    path = (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  ~TempCheckpoint() {
+    std::remove(path.c_str());
+  }
+
+  const char* c_str() const {
+    return path.c_str();
+  }
+};
+
+const char* enumeration_fzn = "array[1..6] of var 0..2: a;\
+  constraint int_plus(a[1], a[2], a[3]);\
+  solve::int_search(a, input_order, indomain_min, complete) satisfy;";
+
+void test_checkpoint_enumeration(int steps, int snapshot_period, const char* fzn = enumeration_fzn) {
+  Model m1(fzn, 6);
+  m1.search_tree->use_recomputation(snapshot_period);
+  int solutions = m1.solve(steps);
+  ASSERT_FALSE(m1.search_tree->is_bot());
+  TempCheckpoint file;
+  EXPECT_TRUE(save_checkpoint(file.c_str(), *m1.search_tree));
+
+  Model m2(fzn, 6);
+  m2.search_tree->use_recomputation(snapshot_period);
+  EXPECT_TRUE(load_checkpoint(file.c_str(), *m2.search_tree, [&](IST&) { return m2.propagate(); }));
+  EXPECT_EQ(m2.search_tree->depth(), m1.search_tree->depth());
+  EXPECT_EQ(m2.search_tree->num_fails(), m1.search_tree->num_fails());
+  solutions += m2.solve(-1);
+  EXPECT_EQ(solutions, 6 * 27);
+}
+
+TEST(CheckpointTest, ResumeEnumeration) {
+  test_checkpoint_enumeration(1, 0);
+  test_checkpoint_enumeration(50, 0);
+  test_checkpoint_enumeration(200, 1);
+  test_checkpoint_enumeration(200, 3);
+}
+
+/** The weights learned by `dom_w_deg` are not saved, the branches are built again from their decisions. */
+TEST(CheckpointTest, ResumeLearnedStrategy) {
+  const char* fzn = "array[1..6] of var 0..2: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    solve::int_search(a, dom_w_deg, indomain_split, complete) satisfy;";
+  test_checkpoint_enumeration(50, 0, fzn);
+  test_checkpoint_enumeration(200, 3, fzn);
+}
+
+const char* optimization_fzn = "array[1..4] of var 0..3: a;\
+  constraint int_plus(a[1], a[2], a[3]);\
+  constraint int_le(a[3], a[4]);\
+  solve::int_search(a, input_order, indomain_min, complete) maximize a[3];";
+
+TEST(CheckpointTest, ResumeOptimization) {
+  Model m1(optimization_fzn, 4);
+  m1.solve(4);
+  ASSERT_FALSE(m1.search_tree->is_bot());
+  TempCheckpoint file;
+  EXPECT_TRUE(save_checkpoint(file.c_str(), *m1.search_tree, *m1.bab));
+
+  Model m2(optimization_fzn, 4);
+  EXPECT_TRUE(load_checkpoint(file.c_str(), *m2.search_tree, *m2.bab, [&](IST&) { return m2.propagate(); }));
+  EXPECT_EQ(m2.bab->solutions_count(), m1.bab->solutions_count());
+  m2.solve(-1);
+  EXPECT_TRUE(m2.bab->is_extractable());
+  EXPECT_EQ(m2.bab->optimum().project(AVar(sty, 2)), Itv(3, 3));
+}
+
+/** The formulas pending in the search tree and the open nodes of the frontier are not saved, so no checkpoint is taken. */
+TEST(CheckpointTest, UnsavedState) {
+  TempCheckpoint file;
+  Model m1(enumeration_fzn, 6);
+  m1.solve(20);
+  ASSERT_FALSE(m1.search_tree->is_bot());
+  EXPECT_TRUE(save_checkpoint(file.c_str(), *m1.search_tree));
+  using F = TFormula<standard_allocator>;
+  F bound = F::make_binary(F::make_avar(AVar(sty, 5)), LEQ, F::make_z(1), sty);
+  IST::tell_type<standard_allocator> t(standard_allocator{});
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(m1.search_tree->interpret_tell(bound, m1.env, t, diagnostics));
+  m1.search_tree->deduce(t);
+  EXPECT_EQ(m1.search_tree->num_pending_root_tells(), 1);
+  EXPECT_FALSE(save_checkpoint(file.c_str(), *m1.search_tree));
+
+  Model m2(optimization_fzn, 4);
+  m2.search_tree->use_frontier(FrontierPolicy::BEST_FIRST, m2.bab->objective_var(), m2.bab->is_minimization());
+  while(!m2.search_tree->is_bot() && m2.search_tree->frontier_size() == 0) {
+    m2.solve(1);
+  }
+  ASSERT_GT(m2.search_tree->frontier_size(), 0);
+  EXPECT_FALSE(save_checkpoint(file.c_str(), *m2.search_tree, *m2.bab));
+}
+
+TEST(CheckpointTest, MissingFile) {
+  Model m(enumeration_fzn, 6);
+  TempCheckpoint file;
+  EXPECT_FALSE(load_checkpoint(file.c_str(), *m.search_tree, [&](IST&) { return m.propagate(); }));
+}
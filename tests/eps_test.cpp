@@ -0,0 +1,86 @@
+// Copyright 2025 Pierre Talbot
+
+#include "lala/search_tree.hpp"
+#include "lala/eps.hpp"
+#include "helper.hpp"
+
+#include <atomic>
+
+using IST = SearchTree<IPC, SplitStrategy<IPC>>;
+
+bool all_assigned(const IStore& a) {
+  for(int i = 0; i < a.vars(); ++i) {
+    if(a[i].lb() != a[i].ub()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void test_eps_enumeration(int num_workers, bool eps_strategy) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..6] of var 0..2: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    solve::int_search(a, input_order, indomain_min, complete) satisfy;");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 6);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, *search_tree, diagnostics));
+
+  std::vector<abstract_ptr<IST>> trees;
+  std::vector<abstract_ptr<IStore>> stores;
+  std::vector<abstract_ptr<IPC>> ipcs;
+  for(int i = 0; i < num_workers; ++i) {
+    AbstractDeps<standard_allocator> deps{standard_allocator{}};
+    trees.push_back(deps.template clone<IST>(search_tree));
+    stores.push_back(deps.template extract<IStore>(store->aty()));
+    ipcs.push_back(deps.template extract<IPC>(ipc->aty()));
+  }
+
+  auto propagate = [&](int w) {
+    local::B has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipcs[w]->num_deductions(),
+      [&](size_t i) { return ipcs[w]->deduce(i); },
+      has_changed
+    );
+    return !ipcs[w]->is_bot();
+  };
+
+  auto eps = eps_strategy
+    ? EPS<IST>(trees, VariableOrder::FIRST_FAIL, ValueOrder::SPLIT)
+    : EPS<IST>(trees);
+  int target = 30 * num_workers;
+  int n = eps.decompose(target, [&](IST&) { return propagate(0); });
+  EXPECT_GE(n, target);
+  EXPECT_EQ(n, eps.num_subproblems());
+
+  std::atomic<int> solutions(0);
+  bool complete = eps.run([&](int w, IST& tree) {
+    propagate(w);
+    if(all_assigned(*stores[w]) && tree.is_extractable()) {
+      solutions++;
+    }
+    tree.deduce();
+    return true;
+  });
+  EXPECT_TRUE(complete);
+  // 6 solutions for `a[1] + a[2] = a[3]` times 27 assignments of the unconstrained variables.
+  EXPECT_EQ(solutions, 6 * 27);
+}
+
+TEST(EPSTest, EnumerationSearchStrategy) {
+  test_eps_enumeration(1, false);
+  test_eps_enumeration(4, false);
+}
+
+TEST(EPSTest, EnumerationDecompositionStrategy) {
+  test_eps_enumeration(1, true);
+  test_eps_enumeration(4, true);
+}
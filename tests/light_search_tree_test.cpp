@@ -0,0 +1,110 @@
+// Copyright 2025 Pierre Talbot
+
+#include "lala/light_search_tree.hpp"
+#include "helper.hpp"
+
+#include <set>
+#include <vector>
+
+using LST = LightSearchTree<IStore, SplitStrategy<IStore>>;
+
+bool all_assigned(const IStore& a) {
+  for(int i = 0; i < a.vars(); ++i) {
+    if(a[i].lb() != a[i].ub()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void test_light_enumeration(const std::string& val_order) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..3] of var 0..2: a;\
+    solve::int_search(a, input_order, " + val_order + ", complete) satisfy;");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 3);
+  auto split = make_shared<SplitStrategy<IStore>, standard_allocator>(env.extends_abstract_dom(), store->aty(), store);
+  auto search_tree = LST(env.extends_abstract_dom(), store, split);
+
+  EXPECT_TRUE(search_tree.is_top());
+  EXPECT_FALSE(search_tree.is_bot());
+
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, search_tree, diagnostics));
+
+  std::set<std::vector<int>> solutions;
+  int iterations = 0;
+  while(!search_tree.is_bot()) {
+    ++iterations;
+    if(all_assigned(*store)) {
+      EXPECT_TRUE(search_tree.is_extractable());
+      std::vector<int> sol;
+      for(int i = 0; i < 3; ++i) {
+        sol.push_back(store->project(AVar(sty, i)).lb().value());
+      }
+      EXPECT_TRUE(solutions.insert(sol).second);
+    }
+    EXPECT_TRUE(search_tree.deduce());
+  }
+  EXPECT_EQ(solutions.size(), 3*3*3);
+  // In a binary tree with 27 leaves, there are 26 internal nodes.
+  EXPECT_EQ(iterations, 27 + 26);
+  EXPECT_EQ(search_tree.statistics().nodes, 27 + 26 - 1);
+  EXPECT_FALSE(search_tree.deduce());
+}
+
+TEST(LightSearchTreeTest, EnumerationSolution) {
+  test_light_enumeration("indomain_min");
+  test_light_enumeration("indomain_max");
+  test_light_enumeration("indomain_split");
+}
+
+TEST(LightSearchTreeTest, FailedSubtrees) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..3] of var 0..2: a;\
+    solve::int_search(a, input_order, indomain_min, complete) satisfy;");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 3);
+  auto split = make_shared<SplitStrategy<IStore>, standard_allocator>(env.extends_abstract_dom(), store->aty(), store);
+  auto search_tree = LST(env.extends_abstract_dom(), store, split);
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, search_tree, diagnostics));
+
+  // With several nodes, the projection is the one of the root node.
+  EXPECT_TRUE(search_tree.deduce());
+  EXPECT_FALSE(search_tree.is_singleton());
+  EXPECT_EQ(store->project(AVar(sty, 0)), Itv(0, 0));
+  EXPECT_EQ(search_tree.project(AVar(sty, 0)), Itv(0, 2));
+
+  std::set<std::vector<int>> solutions;
+  bool told = false;
+  while(!search_tree.is_bot()) {
+    if(all_assigned(*store)) {
+      std::vector<int> sol;
+      for(int i = 0; i < 3; ++i) {
+        sol.push_back(store->project(AVar(sty, i)).lb().value());
+      }
+      EXPECT_TRUE(solutions.insert(sol).second);
+      if(!told) {
+        // The remaining nodes of the subtree `a[1] = 0` fail when we backtrack into them.
+        using F = TFormula<standard_allocator>;
+        F bound = F::make_binary(F::make_avar(AVar(sty, 0)), GEQ, F::make_z(1), sty);
+        LST::tell_type<standard_allocator> t(standard_allocator{});
+        EXPECT_TRUE(search_tree.interpret_tell(bound, env, t, diagnostics));
+        search_tree.deduce(t);
+        told = true;
+      }
+    }
+    search_tree.deduce();
+  }
+  EXPECT_EQ(solutions.size(), 1 + 2*3*3);
+  EXPECT_GT(search_tree.num_fails(), 0);
+  EXPECT_TRUE(search_tree.is_bot());
+  EXPECT_FALSE(search_tree.is_singleton());
+  EXPECT_TRUE(search_tree.project(AVar(sty, 0)).is_bot());
+  EXPECT_FALSE(search_tree.deduce());
+}
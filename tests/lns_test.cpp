@@ -0,0 +1,69 @@
+// Copyright 2025 Pierre Talbot
+
+#include "lala/search_tree.hpp"
+#include "lala/bab.hpp"
+#include "lala/lns.hpp"
+#include "helper.hpp"
+
+using IST = SearchTree<IPC, SplitStrategy<IPC>>;
+using IBAB = BAB<IST, IStore>;
+
+TEST(LNSTest, Relaxations) {
+  std::mt19937 rng(0);
+  std::vector<int> fixed;
+  RandomRelaxation random;
+  random(5, 2, rng, fixed);
+  EXPECT_EQ(fixed.size(), 3);
+  WindowRelaxation window;
+  window(5, 2, rng, fixed);
+  EXPECT_EQ(fixed, std::vector<int>({2, 3, 4}));
+  // The next window starts where the previous one ended.
+  window(5, 2, rng, fixed);
+  EXPECT_EQ(fixed, std::vector<int>({4, 0, 1}));
+}
+
+template <class Relaxation>
+void test_lns(unsigned int seed) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..4] of var 0..3: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    constraint int_le(a[3], a[4]);\
+    solve::int_search(a, input_order, indomain_min, complete) maximize a[3];");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  const size_t num_vars = 4;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), num_vars);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+  auto best = make_shared<IStore, standard_allocator>(store->aty(), num_vars);
+  auto bab = IBAB(env.extends_abstract_dom(), search_tree, best);
+
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, bab, diagnostics));
+
+  std::vector<AVar> vars;
+  for(int i = 0; i < num_vars; ++i) {
+    vars.push_back(AVar(sty, i));
+  }
+  LNS<IST, IStore, Relaxation> lns(search_tree, bab, vars, 5, 0.25, seed);
+  lns.run([&]() {
+    local::B has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipc->num_deductions(),
+      [&](size_t i) { return ipc->deduce(i); },
+      has_changed
+    );
+  }, 100);
+  // The neighborhoods grow until no variable is fixed, and the optimum is then proven.
+  EXPECT_TRUE(lns.is_complete());
+  EXPECT_GT(lns.num_improvements(), 0);
+  EXPECT_EQ(bab.optimum().project(AVar(sty, 2)), Itv(3, 3));
+}
+
+TEST(LNSTest, OptimizeBAB) {
+  test_lns<RandomRelaxation>(0);
+  test_lns<RandomRelaxation>(42);
+  test_lns<WindowRelaxation>(0);
+}
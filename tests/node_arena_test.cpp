@@ -0,0 +1,69 @@
+// Copyright 2025 Pierre Talbot
+
+#include "lala/search_tree.hpp"
+#include "lala/node_arena.hpp"
+#include "helper.hpp"
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+using ArenaSplit = SplitStrategy<IStore, standard_allocator, arena_allocator<>>;
+using ArenaST = SearchTree<IStore, ArenaSplit>;
+
+static_assert(ArenaST::arena_branches);
+static_assert(!SearchTree<IStore, SplitStrategy<IStore>>::arena_branches);
+
+TEST(NodeArenaTest, Levels) {
+  NodeArena<> arena(64);
+  void* p1 = arena.allocate(10);
+  arena.push_level();
+  void* p2 = arena.allocate(100);
+  EXPECT_NE(p1, p2);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p2) % alignof(std::max_align_t), 0);
+  arena.allocate(3);
+  EXPECT_EQ(arena.num_levels(), 1);
+  size_t capacity = arena.capacity();
+  arena.pop_level();
+  EXPECT_EQ(arena.num_levels(), 0);
+  // The memory of the level is reused without new blocks.
+  EXPECT_EQ(arena.allocate(100), p2);
+  EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(NodeArenaTest, EnumerationSolution) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..3] of var 0..2: a;\
+    solve::int_search(a, input_order, indomain_min, complete) satisfy;");
+  EXPECT_TRUE(f);
+  NodeArena<> arena;
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 3);
+  auto split = make_shared<ArenaSplit, standard_allocator>(env.extends_abstract_dom(), store->aty(), store,
+    standard_allocator{}, arena_allocator<>(&arena));
+  auto search_tree = ArenaST(env.extends_abstract_dom(), store, split);
+
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, search_tree, diagnostics));
+
+  std::set<std::vector<int>> solutions;
+  while(!search_tree.is_bot()) {
+    // There is exactly one level of the arena per branch on the stack.
+    EXPECT_EQ(arena.num_levels(), search_tree.depth());
+    bool assigned = true;
+    for(int i = 0; i < 3; ++i) {
+      assigned &= (*store)[i].lb() == (*store)[i].ub();
+    }
+    if(assigned) {
+      std::vector<int> sol;
+      for(int i = 0; i < 3; ++i) {
+        sol.push_back(store->project(AVar(sty, i)).lb().value());
+      }
+      EXPECT_TRUE(solutions.insert(sol).second);
+    }
+    search_tree.deduce();
+  }
+  EXPECT_EQ(solutions.size(), 3*3*3);
+  EXPECT_EQ(arena.num_levels(), 0);
+}
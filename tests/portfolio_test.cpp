@@ -0,0 +1,66 @@
+// Copyright 2025 Pierre Talbot
+
+#include "lala/search_tree.hpp"
+#include "lala/bab.hpp"
+#include "lala/portfolio.hpp"
+#include "helper.hpp"
+
+using IST = SearchTree<IPC, SplitStrategy<IPC>>;
+using IBAB = BAB<IST, IStore>;
+
+void test_portfolio(int num_workers, const std::string& objective, unsigned int seed) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..4] of var 0..5: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    constraint int_le(a[3], a[4]);\
+    solve::int_search(a, input_order, indomain_min, complete) " + objective + ";");
+  EXPECT_TRUE(f);
+  std::vector<abstract_ptr<IST>> trees;
+  std::vector<abstract_ptr<IBAB>> babs;
+  std::vector<abstract_ptr<IPC>> ipcs;
+  for(int i = 0; i < num_workers; ++i) {
+    VarEnv<standard_allocator> env;
+    auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 4);
+    auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+    auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+    auto search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+    auto best = make_shared<IStore, standard_allocator>(store->aty(), 4);
+    auto bab = make_shared<IBAB, standard_allocator>(env.extends_abstract_dom(), search_tree, best);
+    IDiagnostics diagnostics;
+    EXPECT_TRUE(interpret_and_tell<true>(*f, env, *bab, diagnostics));
+    trees.push_back(search_tree);
+    babs.push_back(bab);
+    ipcs.push_back(ipc);
+  }
+  Portfolio<IST, IStore> portfolio(trees, babs, 4, seed);
+  bool complete = portfolio.run([&](int w) {
+    local::B has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipcs[w]->num_deductions(),
+      [&](size_t i) { return ipcs[w]->deduce(i); },
+      has_changed
+    );
+  });
+  EXPECT_TRUE(complete);
+  EXPECT_NE(portfolio.winning_worker(), -1);
+  int w = portfolio.best_worker();
+  ASSERT_NE(w, -1);
+  const IStore& sol = portfolio.bab(w).optimum();
+  EXPECT_EQ(sol.project(AVar(sty, 0)).lb().value() + sol.project(AVar(sty, 1)).lb().value(), sol.project(AVar(sty, 2)).lb().value());
+  if(objective != "satisfy") {
+    std::vector<int64_t> lb, ub;
+    int64_t value;
+    EXPECT_TRUE(portfolio.shared_bound()->read_solution(lb, ub, value));
+    EXPECT_EQ(value, objective == "maximize a[3]" ? 5 : 0);
+    EXPECT_EQ(sol.project(AVar(sty, 2)), Itv(value, value));
+  }
+}
+
+TEST(PortfolioTest, Optimization) {
+  for(int num_workers : {1, 2, 4, 8}) {
+    test_portfolio(num_workers, "maximize a[3]", 0);
+    test_portfolio(num_workers, "minimize a[3]", 42);
+    test_portfolio(num_workers, "satisfy", 0);
+  }
+}
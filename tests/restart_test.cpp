@@ -0,0 +1,62 @@
+// Copyright 2025 Pierre Talbot
+
+#include "lala/search_tree.hpp"
+#include "lala/bab.hpp"
+#include "lala/restart.hpp"
+#include "helper.hpp"
+
+TEST(RestartTest, LubySequence) {
+  std::vector<long> expected = {1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, 1};
+  for(int i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(luby(i + 1), expected[i]);
+  }
+}
+
+using IST = SearchTree<IPC, SplitStrategy<IPC>>;
+using IBAB = BAB<IST, IStore>;
+
+void test_restart_bab(RestartPolicy policy, const std::string& var_order) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..4] of var 0..3: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    constraint int_le(a[3], a[4]);\
+    solve::int_search(a, " + var_order + ", indomain_min, complete) maximize a[3];");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  const size_t num_vars = 4;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), num_vars);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+  auto best = make_shared<IStore, standard_allocator>(store->aty(), num_vars);
+  auto bab = IBAB(env.extends_abstract_dom(), search_tree, best);
+
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, bab, diagnostics));
+
+  RestartController restarts(policy, 1, 1.5, 42);
+  local::B has_changed{true};
+  while(!bab.is_extractable() && has_changed) {
+    has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipc->num_deductions(),
+      [&](size_t i) { return ipc->deduce(i); },
+      has_changed
+    );
+    if(search_tree->is_extractable()) {
+      has_changed |= bab.deduce();
+    }
+    has_changed |= search_tree->deduce();
+    has_changed |= restarts.restart_if_needed(*search_tree);
+  }
+  EXPECT_TRUE(bab.is_extractable());
+  EXPECT_EQ(bab.optimum().project(AVar(sty, 2)), Itv(3, 3));
+  EXPECT_GT(restarts.num_restarts(), 0);
+}
+
+TEST(RestartTest, RestartBAB) {
+  test_restart_bab(RestartPolicy::LUBY, "input_order");
+  test_restart_bab(RestartPolicy::GEOMETRIC, "input_order");
+  test_restart_bab(RestartPolicy::LUBY, "random");
+}
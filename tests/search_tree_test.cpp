@@ -3,6 +3,11 @@
 #include "lala/search_tree.hpp"
 #include "helper.hpp"
 
+#include <set>
+#include <vector>
+#include <thread>
+#include <atomic>
+
 using ST = SearchTree<IStore, SplitStrategy<IStore>>;
 
 template <class A>
@@ -76,7 +81,7 @@ TEST(SearchTreeTest, EnumerationSolution) {
 
 using IST = SearchTree<IPC, SplitStrategy<IPC>>;
 
-TEST(SearchTreeTest, ConstrainedEnumeration) {
+void test_constrained_enumeration(int snapshot_period, bool adaptive) {
   SolverOutput<standard_allocator> output(standard_allocator{});
   lala::impl::FlatZincParser<standard_allocator> parser(output);
   auto f = parser.parse("array[1..3] of var 0..2: a;\
@@ -88,6 +93,7 @@ TEST(SearchTreeTest, ConstrainedEnumeration) {
   auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
   auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
   auto search_tree = IST(env.extends_abstract_dom(), ipc, split);
+  search_tree.use_recomputation(snapshot_period, adaptive);
 
   EXPECT_TRUE(search_tree.is_top());
   EXPECT_FALSE(search_tree.is_bot());
@@ -139,3 +145,385 @@ TEST(SearchTreeTest, ConstrainedEnumeration) {
   EXPECT_FALSE(search_tree.is_top());
   EXPECT_EQ(solutions, sols.size());
 }
+
+TEST(SearchTreeTest, ConstrainedEnumeration) {
+  test_constrained_enumeration(0, false);
+}
+
+TEST(SearchTreeTest, ConstrainedEnumerationTrail) {
+  test_constrained_enumeration(1, false);
+}
+
+TEST(SearchTreeTest, ConstrainedEnumerationRecomputation) {
+  test_constrained_enumeration(2, false);
+  test_constrained_enumeration(1, true);
+}
+
+void test_discrepancy_enumeration(TreeExploration exploration, int snapshot_period) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..3] of var 0..2: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    solve::int_search(a, input_order, indomain_min, complete) satisfy;");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 3);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = IST(env.extends_abstract_dom(), ipc, split);
+  search_tree.use_recomputation(snapshot_period);
+  search_tree.use_exploration(exploration);
+
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, search_tree, diagnostics));
+
+  // The solutions are found in the order of their number of discrepancies (LDS) or of the depth of their last discrepancy (DDS).
+  std::set<std::vector<int>> sols;
+  int visited = 0;
+  local::B has_changed(true);
+  while(has_changed) {
+    has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipc->num_deductions(),
+      [&](size_t i) { return ipc->deduce(i); },
+      has_changed
+    );
+    if(all_assigned(*store) && search_tree.is_extractable()) {
+      ++visited;
+      if(!search_tree.is_revisited()) {
+        std::vector<int> sol;
+        for(int i = 0; i < 3; ++i) {
+          sol.push_back((*store)[i].lb().value());
+        }
+        EXPECT_TRUE(sols.insert(sol).second);
+      }
+    }
+    has_changed |= search_tree.deduce();
+  }
+  EXPECT_TRUE(search_tree.is_bot());
+  EXPECT_EQ(sols.size(), 6);
+  EXPECT_GT(visited, 6);
+  EXPECT_TRUE(sols.contains({0, 0, 0}));
+  EXPECT_TRUE(sols.contains({1, 1, 2}));
+  EXPECT_TRUE(sols.contains({2, 0, 2}));
+}
+
+TEST(SearchTreeTest, LimitedDiscrepancySearch) {
+  test_discrepancy_enumeration(TreeExploration::LDS, 0);
+  test_discrepancy_enumeration(TreeExploration::LDS, 1);
+}
+
+TEST(SearchTreeTest, DepthBoundedDiscrepancySearch) {
+  test_discrepancy_enumeration(TreeExploration::DDS, 0);
+  test_discrepancy_enumeration(TreeExploration::DDS, 1);
+}
+
+TEST(SearchTreeTest, ProjectionRootNode) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..3] of var 0..2: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    solve::int_search(a, input_order, indomain_min, complete) satisfy;");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 3);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = IST(env.extends_abstract_dom(), ipc, split);
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, search_tree, diagnostics));
+
+  EXPECT_TRUE(search_tree.is_singleton());
+  EXPECT_EQ(search_tree.project(AVar(sty, 0)), Itv(0, 2));
+  EXPECT_TRUE(search_tree.deduce());
+  EXPECT_FALSE(search_tree.is_singleton());
+  // The current node is `a[1] = 0` but the projection is done on the root node.
+  EXPECT_EQ(store->project(AVar(sty, 0)), Itv(0, 0));
+  EXPECT_EQ(search_tree.project(AVar(sty, 0)), Itv(0, 2));
+  EXPECT_EQ(search_tree.project(AVar(sty, 2)), Itv(0, 2));
+}
+
+/** A monitor projects the variables in another thread during the search, it must only observe the projections published in root. */
+TEST(SearchTreeTest, ProjectionConcurrentSearch) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..6] of var 0..2: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    solve::int_search(a, input_order, indomain_min, complete) satisfy;");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 6);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = IST(env.extends_abstract_dom(), ipc, split);
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, search_tree, diagnostics));
+  using F = TFormula<standard_allocator>;
+  F bound = F::make_binary(F::make_avar(AVar(sty, 5)), LEQ, F::make_z(1), sty);
+  IST::tell_type<standard_allocator> t(standard_allocator{});
+  EXPECT_TRUE(search_tree.interpret_tell(bound, env, t, diagnostics));
+
+  auto propagate = [&]() {
+    local::B has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipc->num_deductions(),
+      [&](size_t i) { return ipc->deduce(i); },
+      has_changed
+    );
+  };
+  // The projection of a singleton reads the sub-domain, so the monitor starts once the root node is split.
+  propagate();
+  search_tree.deduce();
+  EXPECT_FALSE(search_tree.is_singleton());
+
+  std::atomic<bool> done(false);
+  std::atomic<int> unexpected(0);
+  std::thread monitor([&]() {
+    while(!done) {
+      for(int i = 0; i < 6; ++i) {
+        Itv u = search_tree.project(AVar(sty, i));
+        if(!u.is_bot() && u != Itv(0, 2) && !(i == 5 && u == Itv(0, 1))) {
+          ++unexpected;
+        }
+      }
+    }
+  });
+  int solutions = 0;
+  while(!search_tree.is_bot()) {
+    propagate();
+    if(all_assigned(*store) && search_tree.is_extractable()) {
+      // The bound is deduced in root on the next backtrack to root, which publishes a new projection.
+      if(++solutions == 20) {
+        search_tree.deduce(t);
+      }
+    }
+    search_tree.deduce();
+  }
+  done = true;
+  monitor.join();
+  EXPECT_EQ(unexpected, 0);
+  EXPECT_EQ(search_tree.project(AVar(sty, 0)), Itv::bot());
+}
+
+TEST(SearchTreeTest, Statistics) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..3] of var 0..2: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    solve::int_search(a, input_order, indomain_min, complete) satisfy;");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 3);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = IST(env.extends_abstract_dom(), ipc, split);
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, search_tree, diagnostics));
+  search_tree.statistics().track_depths();
+
+  local::B has_changed(true);
+  while(has_changed) {
+    has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipc->num_deductions(),
+      [&](size_t i) { return ipc->deduce(i); },
+      has_changed
+    );
+    has_changed |= search_tree.deduce();
+  }
+  search_tree.statistics().stop_timer();
+  const auto& stats = search_tree.statistics();
+  EXPECT_GT(stats.nodes, 0);
+  EXPECT_EQ(stats.fails, search_tree.num_fails());
+  // Each leaf node (the 6 solutions and the failed nodes) leads to a backtrack.
+  EXPECT_EQ(stats.backtracks, 6 + stats.fails);
+  EXPECT_EQ(stats.solutions, 0);
+  EXPECT_GT(stats.max_depth, 0);
+  EXPECT_EQ(stats.nodes_per_depth.size(), stats.max_depth);
+  size_t nodes = 0;
+  for(int i = 0; i < stats.nodes_per_depth.size(); ++i) {
+    nodes += stats.nodes_per_depth[i];
+  }
+  EXPECT_EQ(nodes, stats.nodes);
+  EXPECT_GE(stats.search_time, 0);
+
+  SearchStatistics<standard_allocator> merged(stats);
+  merged.merge(stats);
+  EXPECT_EQ(merged.nodes, 2 * stats.nodes);
+  EXPECT_EQ(merged.max_depth, stats.max_depth);
+  EXPECT_EQ(merged.nodes_per_depth[0], 2 * stats.nodes_per_depth[0]);
+}
+
+struct PriorityIndexProblem {
+  VarEnv<standard_allocator> env;
+  shared_ptr<IStore, standard_allocator> store;
+  shared_ptr<IPC, standard_allocator> ipc;
+  shared_ptr<SplitStrategy<IPC>, standard_allocator> split;
+  shared_ptr<IST, standard_allocator> search_tree;
+
+  PriorityIndexProblem(const std::string& var_order, bool priority_index) {
+    SolverOutput<standard_allocator> output(standard_allocator{});
+    lala::impl::FlatZincParser<standard_allocator> parser(output);
+    auto f = parser.parse("var 0..4: x; var 1..3: y; var 0..6: z; var 2..5: w;\
+      constraint int_plus(x, y, z);\
+      solve::int_search([w, z, y, x], " + var_order + ", indomain_split, complete) satisfy;");
+    EXPECT_TRUE(f);
+    store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 4);
+    ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+    split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+    split->use_priority_index(priority_index);
+    search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+    IDiagnostics diagnostics;
+    EXPECT_TRUE(interpret_and_tell<true>(*f, env, *search_tree, diagnostics));
+  }
+
+  void propagate() {
+    local::B has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipc->num_deductions(),
+      [&](size_t i) { return ipc->deduce(i); },
+      has_changed
+    );
+  }
+};
+
+void test_priority_index(const std::string& var_order, int snapshot_period) {
+  PriorityIndexProblem scan(var_order, false);
+  PriorityIndexProblem indexed(var_order, true);
+  indexed.search_tree->use_recomputation(snapshot_period);
+  int iterations = 0;
+  while(!scan.search_tree->is_bot()) {
+    ASSERT_FALSE(indexed.search_tree->is_bot());
+    scan.propagate();
+    indexed.propagate();
+    // Both searches split on the same variables, and therefore explore the same nodes.
+    for(int i = 0; i < 4; ++i) {
+      EXPECT_EQ((*scan.store)[i], (*indexed.store)[i]);
+    }
+    scan.search_tree->deduce();
+    indexed.search_tree->deduce();
+    ++iterations;
+  }
+  EXPECT_TRUE(indexed.search_tree->is_bot());
+  EXPECT_GT(iterations, 1);
+}
+
+TEST(SearchTreeTest, PriorityIndex) {
+  for(const char* var_order : {"smallest", "largest", "anti_first_fail", "first_fail"}) {
+    test_priority_index(var_order, 0);
+    test_priority_index(var_order, 1);
+    test_priority_index(var_order, 2);
+  }
+}
+
+/** \return the index of the unassigned variable with the smallest width among `vars`, the first one in case of ties. */
+int naive_first_fail(const IStore& store, const std::vector<int>& vars) {
+  int best = -1;
+  for(int i : vars) {
+    if(store[i].lb() != store[i].ub()
+     && (best == -1 || store[i].width().ub().value() < store[best].width().ub().value()))
+    {
+      best = i;
+    }
+  }
+  return best;
+}
+
+TEST(SearchTreeTest, LiveVariables) {
+  for(int snapshot_period : {0, 1, 2}) {
+    PriorityIndexProblem p("first_fail", false);
+    p.search_tree->use_recomputation(snapshot_period);
+    int checks = 0;
+    while(!p.search_tree->is_bot()) {
+      p.propagate();
+      int expected = naive_first_fail(*p.store, {3, 2, 1, 0});
+      int depth = p.search_tree->depth();
+      p.search_tree->deduce();
+      // The variable split is selected among the live variables, which must be restored on backtracking.
+      if(p.search_tree->depth() == depth + 1) {
+        EXPECT_EQ(p.search_tree->branch_at(depth).var().vid(), expected);
+        ++checks;
+      }
+    }
+    EXPECT_GT(checks, 1);
+  }
+}
+
+/** Without constraints, the activities and the impacts only measure the decisions, hence they must not depend on the decisions replayed on backtracking.
+ * `measure(split, x)` returns the measures of `x` compared between the recomputation periods. */
+template <class Measure>
+void test_recomputation_measures(const std::string& var_order, Measure measure) {
+  std::vector<std::vector<int>> splits;
+  std::vector<std::vector<double>> measures;
+  for(int snapshot_period : {0, 1, 2}) {
+    SolverOutput<standard_allocator> output(standard_allocator{});
+    lala::impl::FlatZincParser<standard_allocator> parser(output);
+    auto f = parser.parse("array[1..4] of var 0..2: a;\
+      solve::int_search(a, " + var_order + ", indomain_min, complete) satisfy;");
+    EXPECT_TRUE(f);
+    VarEnv<standard_allocator> env;
+    auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 4);
+    auto split = make_shared<SplitStrategy<IStore>, standard_allocator>(env.extends_abstract_dom(), store->aty(), store);
+    auto search_tree = ST(env.extends_abstract_dom(), store, split);
+    search_tree.use_recomputation(snapshot_period);
+    IDiagnostics diagnostics;
+    EXPECT_TRUE(interpret_and_tell<true>(*f, env, search_tree, diagnostics));
+    splits.emplace_back();
+    while(!search_tree.is_bot()) {
+      int depth = search_tree.depth();
+      search_tree.deduce();
+      if(search_tree.depth() == depth + 1) {
+        splits.back().push_back(search_tree.branch_at(depth).var().vid());
+      }
+    }
+    measures.emplace_back();
+    for(int i = 0; i < 4; ++i) {
+      for(double m : measure(*split, AVar(store->aty(), i))) {
+        measures.back().push_back(m);
+      }
+    }
+  }
+  // Full recomputation (period 0) replays the whole path from root, trail mode (period 1) only the last decision.
+  for(int k = 1; k < splits.size(); ++k) {
+    EXPECT_EQ(splits[k], splits[0]);
+    for(int i = 0; i < measures[0].size(); ++i) {
+      EXPECT_DOUBLE_EQ(measures[k][i], measures[0][i]);
+    }
+  }
+}
+
+TEST(SearchTreeTest, ActivityRecomputation) {
+  test_recomputation_measures("activity", [](const SplitStrategy<IStore>& split, AVar x) {
+    return std::vector<double>{split.activity_of(x)};
+  });
+}
+
+TEST(SearchTreeTest, ImpactRecomputation) {
+  test_recomputation_measures("impact", [](const SplitStrategy<IStore>& split, AVar x) {
+    return std::vector<double>{split.impact_of(x, 0), split.impact_of(x, 1)};
+  });
+}
+
+TEST(SearchTreeTest, Impact) {
+  PriorityIndexProblem p("impact", false);
+  p.propagate();
+  p.split->probe_impacts([&]() { p.propagate(); });
+  // Probing restores the root node, and measures the impact of both children of each variable.
+  EXPECT_EQ((*p.store)[2], Itv(1, 6));
+  for(int i = 0; i < 4; ++i) {
+    EXPECT_GT(p.split->impact_of(AVar(p.store->aty(), i), 0), 0);
+    EXPECT_GT(p.split->impact_of(AVar(p.store->aty(), i), 1), 0);
+  }
+  int solutions = 0;
+  while(!p.search_tree->is_bot()) {
+    p.propagate();
+    bool assigned = !p.ipc->is_bot();
+    for(int i = 0; i < 4; ++i) {
+      assigned &= (*p.store)[i].lb() == (*p.store)[i].ub();
+    }
+    solutions += assigned;
+    p.search_tree->deduce();
+  }
+  // `x + y = z` has 14 solutions, and `w` is free with 4 values.
+  EXPECT_EQ(solutions, 14 * 4);
+}
@@ -0,0 +1,99 @@
+// Copyright 2025 Pierre Talbot
+
+#include "lala/search_tree.hpp"
+#include "lala/bab.hpp"
+#include "lala/shared_bound.hpp"
+#include "helper.hpp"
+
+#include <thread>
+#include <memory>
+
+using IST = SearchTree<IPC, SplitStrategy<IPC>>;
+using IBAB = BAB<IST, IStore>;
+
+TEST(SharedBoundTest, Publish) {
+  SharedBound shared(true, 2);
+  EXPECT_FALSE(shared.has_bound());
+  std::vector<int64_t> lb, ub;
+  int64_t value;
+  EXPECT_FALSE(shared.read_solution(lb, ub, value));
+  VarEnv<standard_allocator> env;
+  IStore sol(env.extends_abstract_dom(), 2);
+  sol.embed(AVar(sol.aty(), 0), Itv(4, 4));
+  sol.embed(AVar(sol.aty(), 1), Itv(1, 1));
+  EXPECT_TRUE(shared.publish(AVar(sol.aty(), 1), sol));
+  EXPECT_EQ(shared.bound(), 1);
+  // A worse bound is rejected.
+  EXPECT_FALSE(shared.offer(3));
+  EXPECT_EQ(shared.bound(), 1);
+  EXPECT_TRUE(shared.read_solution(lb, ub, value));
+  EXPECT_EQ(value, 1);
+  EXPECT_EQ(lb, std::vector<int64_t>({4, 1}));
+  EXPECT_EQ(ub, std::vector<int64_t>({4, 1}));
+}
+
+struct Worker {
+  VarEnv<standard_allocator> env;
+  shared_ptr<IStore, standard_allocator> store;
+  shared_ptr<IPC, standard_allocator> ipc;
+  shared_ptr<IST, standard_allocator> search_tree;
+  std::unique_ptr<IBAB> bab;
+
+  Worker(const std::string& val_order) {
+    SolverOutput<standard_allocator> output(standard_allocator{});
+    lala::impl::FlatZincParser<standard_allocator> parser(output);
+    auto f = parser.parse("array[1..4] of var 0..5: a;\
+      constraint int_plus(a[1], a[2], a[3]);\
+      constraint int_le(a[3], a[4]);\
+      solve::int_search(a, input_order, " + val_order + ", complete) maximize a[3];");
+    EXPECT_TRUE(f);
+    store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 4);
+    ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+    auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+    search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+    auto best = make_shared<IStore, standard_allocator>(store->aty(), 4);
+    bab = std::make_unique<IBAB>(env.extends_abstract_dom(), search_tree, best);
+    IDiagnostics diagnostics;
+    EXPECT_TRUE(interpret_and_tell<true>(*f, env, *bab, diagnostics));
+  }
+
+  void solve(SharedBound& shared) {
+    SharedBoundClient<IBAB> client(shared, *bab);
+    while(!search_tree->is_bot()) {
+      client.poll();
+      local::B has_changed = false;
+      GaussSeidelIteration{}.fixpoint(
+        ipc->num_deductions(),
+        [&](size_t i) { return ipc->deduce(i); },
+        has_changed
+      );
+      if(search_tree->is_extractable()) {
+        bab->deduce();
+        client.publish();
+      }
+      search_tree->deduce();
+    }
+  }
+};
+
+TEST(SharedBoundTest, ConcurrentBAB) {
+  SharedBound shared(false, 4);
+  std::vector<std::unique_ptr<Worker>> workers;
+  for(const char* val_order : {"indomain_min", "indomain_max", "indomain_split"}) {
+    workers.push_back(std::make_unique<Worker>(val_order));
+  }
+  std::vector<std::thread> threads;
+  for(auto& w : workers) {
+    threads.emplace_back([&]() { w->solve(shared); });
+  }
+  for(auto& t : threads) {
+    t.join();
+  }
+  std::vector<int64_t> lb, ub;
+  int64_t value;
+  EXPECT_TRUE(shared.read_solution(lb, ub, value));
+  EXPECT_EQ(value, 5);
+  EXPECT_EQ(lb, ub);
+  EXPECT_EQ(lb[0] + lb[1], lb[2]);
+  EXPECT_LE(lb[2], lb[3]);
+}
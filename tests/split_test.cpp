@@ -3,6 +3,12 @@
 #include "helper.hpp"
 #include "battery/memory.hpp"
 
+#include <vector>
+
+// The branches on a store are built directly from the universes of the variables, the other domains go through the interpretation of formulas.
+static_assert(SplitStrategy<IStore>::direct_tells);
+static_assert(!SplitStrategy<IPC>::direct_tells);
+
 void apply_branch_and_test(
   shared_ptr<IStore, standard_allocator> store,
   const IStore::tell_type<standard_allocator>& branch,
@@ -20,7 +26,8 @@ void test_strategy(
   const std::string& value_order,
   int var_idx,
   Itv left,
-  Itv right)
+  Itv right,
+  const std::vector<int>& failures = {})
 {
   SolverOutput<standard_allocator> output(standard_allocator{});
   lala::impl::FlatZincParser<standard_allocator> parser(output);
@@ -41,11 +48,15 @@ void test_strategy(
   SplitStrategy<IStore>::tell_type<standard_allocator> split_tell;
   EXPECT_TRUE(split->template interpret_tell<true>(*strat, env, split_tell, diagnostics));
   split->deduce(split_tell);
+  for(int x : failures) {
+    split->on_failure(AVar(store->aty(), x));
+  }
   auto branches = split->split();
   auto left_branch = branches.next();
   EXPECT_EQ(branches.size(), 2);
   EXPECT_EQ(left_branch.size(), 1);
   EXPECT_EQ(left_branch[0].avar.vid(), var_idx);
+  EXPECT_EQ(branches.var().vid(), var_idx);
   apply_branch_and_test(store, left_branch, var_idx, left);
   auto right_branch = branches.next();
   EXPECT_EQ(branches.size(), 2);
@@ -81,6 +92,12 @@ TEST(BranchTest, InputOrderTest) {
   test_strategy("largest", "indomain_max", 5, Itv(10, 10), Itv(2, 9));
   test_strategy("largest", "indomain_split", 5, Itv(2, 6), Itv(7, 10));
   test_strategy("largest", "indomain_reverse_split", 5, Itv(7, 10), Itv(2, 6));
+
+  // Without failures, all the weights are equal and `dom_w_deg` behaves as `first_fail`.
+  test_strategy("dom_w_deg", "indomain_min", 3, Itv(4, 4), Itv(5, 6));
+  // The weight of x2 becomes 4, and its ratio 5/4 is smaller than the ratio 2/1 of x4.
+  test_strategy("dom_w_deg", "indomain_min", 1, Itv(3, 3), Itv(4, 8), {1, 1, 1});
+  test_strategy("dom_w_deg", "indomain_min", 3, Itv(4, 4), Itv(5, 6), {1});
 }
 
 using AItv = Interval<ZLB<int, battery::atomic_memory<>>>;
@@ -95,3 +112,102 @@ TEST(BranchTest, CopySplitStrategy) {
   AbstractDeps<standard_allocator> deps{standard_allocator()};
   auto r = deps.template clone<SplitStrategy<AIStore>>(split);
 }
+
+TEST(BranchTest, Activity) {
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 3);
+  for(int i = 0; i < 3; ++i) {
+    store->embed(AVar(store->aty(), i), Itv(0, 5));
+  }
+  auto split = make_shared<SplitStrategy<IStore>, standard_allocator>(env.extends_abstract_dom(), store->aty(), store);
+  SplitStrategy<IStore>::tell_type<standard_allocator> split_tell;
+  split_tell.push_back(StrategyType<standard_allocator>(VariableOrder::ACTIVITY, ValueOrder::MIN, vector<AVar, standard_allocator>()));
+  split->deduce(split_tell);
+  // All activities are null, so the first variable is selected.
+  auto branches = split->split();
+  EXPECT_EQ(branches.var().vid(), 0);
+  // The domain of x2 changes between two splits, so it becomes the most active variable.
+  store->embed(AVar(store->aty(), 2), Itv(1, 4));
+  auto branches2 = split->split();
+  EXPECT_EQ(branches2.var().vid(), 2);
+  EXPECT_GT(split->activity_of(AVar(store->aty(), 2)), 0);
+  EXPECT_EQ(split->activity_of(AVar(store->aty(), 0)), 0);
+  // After a restore, the search tree replays the decisions leading to the right child, only the decision of this child is counted.
+  auto store_snap = store->snapshot();
+  auto snap = split->snapshot();
+  store->embed(AVar(store->aty(), 0), Itv(0, 0));
+  store->restore(store_snap);
+  split->restore(snap);
+  store->embed(AVar(store->aty(), 0), Itv(0, 3));
+  store->embed(AVar(store->aty(), 1), Itv(4, 5));
+  split->on_replayed(AVar(store->aty(), 1));
+  EXPECT_GT(split->activity_of(AVar(store->aty(), 1)), 0);
+  split->split();
+  EXPECT_EQ(split->activity_of(AVar(store->aty(), 0)), 0);
+  // A failure on a decision also bumps its variable.
+  split->on_failure(AVar(store->aty(), 0));
+  EXPECT_GT(split->activity_of(AVar(store->aty(), 0)), 0);
+}
+
+TEST(BranchTest, Impact) {
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 3);
+  for(int i = 0; i < 3; ++i) {
+    store->embed(AVar(store->aty(), i), Itv(0, 7));
+  }
+  auto split = make_shared<SplitStrategy<IStore>, standard_allocator>(env.extends_abstract_dom(), store->aty(), store);
+  SplitStrategy<IStore>::tell_type<standard_allocator> split_tell;
+  split_tell.push_back(StrategyType<standard_allocator>(VariableOrder::IMPACT, ValueOrder::SPLIT, vector<AVar, standard_allocator>()));
+  split->deduce(split_tell);
+  AVar x0(store->aty(), 0);
+  auto branches = split->split();
+  EXPECT_EQ(branches.var(), x0);
+  auto store_snap = store->snapshot();
+  auto snap = split->snapshot();
+  // The impact of the left child is measured at the next split.
+  store->embed(x0, Itv(0, 3));
+  split->split();
+  EXPECT_DOUBLE_EQ(split->impact_of(x0, 0), 0.5);
+  EXPECT_EQ(split->impact_of(x0, 1), 0);
+  // The impact of the right child is measured from its parent, in which the search tree calls `on_commit` before deducing the child.
+  store->restore(store_snap);
+  split->restore(snap);
+  split->on_commit(x0, 1);
+  store->embed(x0, Itv(4, 7));
+  split->split();
+  EXPECT_DOUBLE_EQ(split->impact_of(x0, 1), 0.5);
+}
+
+TEST(BranchTest, SolutionPhase) {
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 2);
+  for(int i = 0; i < 2; ++i) {
+    store->embed(AVar(store->aty(), i), Itv(0, 5));
+  }
+  auto split = make_shared<SplitStrategy<IStore>, standard_allocator>(env.extends_abstract_dom(), store->aty(), store);
+  SplitStrategy<IStore>::tell_type<standard_allocator> split_tell;
+  split_tell.push_back(StrategyType<standard_allocator>(VariableOrder::INPUT_ORDER, ValueOrder::SOLUTION, vector<AVar, standard_allocator>()));
+  split->deduce(split_tell);
+  // Without solution, the fallback value order is used.
+  auto branches = split->split();
+  apply_branch_and_test(store, branches.next(), 0, Itv(0, 0));
+  apply_branch_and_test(store, branches.next(), 0, Itv(1, 5));
+  // The domain is split on the value of the solution, and this value is tried first.
+  IStore sol(store->aty(), 2);
+  sol.embed(AVar(store->aty(), 0), Itv(3, 3));
+  sol.embed(AVar(store->aty(), 1), Itv(5, 5));
+  split->save_phase(sol);
+  auto branches2 = split->split();
+  apply_branch_and_test(store, branches2.next(), 0, Itv(0, 3));
+  apply_branch_and_test(store, branches2.next(), 0, Itv(4, 5));
+  store->embed(AVar(store->aty(), 0), Itv(3, 3));
+  auto branches3 = split->split();
+  apply_branch_and_test(store, branches3.next(), 1, Itv(5, 5));
+  apply_branch_and_test(store, branches3.next(), 1, Itv(0, 4));
+  // When the value of the solution is not in the domain, we use the fallback order.
+  store->embed(AVar(store->aty(), 1), Itv(1, 4));
+  split->set_phase_fallback(ValueOrder::MAX);
+  auto branches4 = split->split();
+  apply_branch_and_test(store, branches4.next(), 1, Itv(4, 4));
+  apply_branch_and_test(store, branches4.next(), 1, Itv(1, 3));
+}
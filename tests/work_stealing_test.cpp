@@ -0,0 +1,129 @@
+// Copyright 2025 Pierre Talbot
+
+#include "lala/search_tree.hpp"
+#include "lala/work_stealing.hpp"
+#include "helper.hpp"
+
+#include <atomic>
+
+using IST = SearchTree<IPC, SplitStrategy<IPC>>;
+
+bool all_assigned(const IStore& a) {
+  for(int i = 0; i < a.vars(); ++i) {
+    if(a[i].lb() != a[i].ub()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void test_parallel_enumeration(int num_workers) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..6] of var 0..2: a;\
+    constraint int_plus(a[1], a[2], a[3]);\
+    solve::int_search(a, input_order, indomain_min, complete) satisfy;");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 6);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, *search_tree, diagnostics));
+
+  std::vector<abstract_ptr<IST>> trees;
+  std::vector<abstract_ptr<IStore>> stores;
+  std::vector<abstract_ptr<IPC>> ipcs;
+  for(int i = 0; i < num_workers; ++i) {
+    AbstractDeps<standard_allocator> deps{standard_allocator{}};
+    trees.push_back(deps.template clone<IST>(search_tree));
+    stores.push_back(deps.template extract<IStore>(store->aty()));
+    ipcs.push_back(deps.template extract<IPC>(ipc->aty()));
+  }
+
+  WorkStealing<IST> parallel_search(trees);
+  std::atomic<int> solutions(0);
+  bool complete = parallel_search.run([&](int w, IST& tree) {
+    local::B has_changed = false;
+    GaussSeidelIteration{}.fixpoint(
+      ipcs[w]->num_deductions(),
+      [&](size_t i) { return ipcs[w]->deduce(i); },
+      has_changed
+    );
+    if(all_assigned(*stores[w]) && tree.is_extractable()) {
+      solutions++;
+    }
+    tree.deduce();
+    return true;
+  });
+  EXPECT_TRUE(complete);
+  // 6 solutions for `a[1] + a[2] = a[3]` times 27 assignments of the unconstrained variables.
+  EXPECT_EQ(solutions, 6 * 27);
+  for(int i = 0; i < num_workers; ++i) {
+    EXPECT_TRUE(trees[i]->is_bot());
+  }
+}
+
+TEST(WorkStealingTest, ParallelEnumeration) {
+  test_parallel_enumeration(1);
+  test_parallel_enumeration(2);
+  test_parallel_enumeration(4);
+}
+
+TEST(WorkStealingTest, StealToldFormulas) {
+  SolverOutput<standard_allocator> output(standard_allocator{});
+  lala::impl::FlatZincParser<standard_allocator> parser(output);
+  auto f = parser.parse("array[1..3] of var 0..2: a;\
+    solve::int_search(a, input_order, indomain_min, complete) satisfy;");
+  EXPECT_TRUE(f);
+  VarEnv<standard_allocator> env;
+  auto store = make_shared<IStore, standard_allocator>(env.extends_abstract_dom(), 3);
+  auto ipc = make_shared<IPC, standard_allocator>(IPC(env.extends_abstract_dom(), store));
+  auto split = make_shared<SplitStrategy<IPC>, standard_allocator>(env.extends_abstract_dom(), store->aty(), ipc);
+  auto search_tree = make_shared<IST, standard_allocator>(env.extends_abstract_dom(), ipc, split);
+  IDiagnostics diagnostics;
+  EXPECT_TRUE(interpret_and_tell<true>(*f, env, *search_tree, diagnostics));
+
+  AbstractDeps<standard_allocator> deps{standard_allocator{}};
+  auto thief = deps.template clone<IST>(search_tree);
+  auto thief_store = deps.template extract<IStore>(store->aty());
+  auto root = thief->snapshot(thief->get_allocator());
+  // The formulas of the problem are already in `root`, they are not told again to the thief.
+  search_tree->restore(search_tree->snapshot(search_tree->get_allocator()));
+
+  using F = TFormula<standard_allocator>;
+  // A formula told in root (e.g., a bound of branch-and-bound found before the first split), with a strategy for the split strategy.
+  F lower = F::make_binary(F::make_avar(AVar(store->aty(), 1)), GEQ, F::make_z(1), store->aty());
+  IST::tell_type<standard_allocator> t1(standard_allocator{});
+  EXPECT_TRUE(search_tree->interpret_tell(lower, env, t1, diagnostics));
+  t1.split_tell.push_back(StrategyType<standard_allocator>(VariableOrder::INPUT_ORDER, ValueOrder::MAX,
+    battery::vector<AVar, standard_allocator>({AVar(store->aty(), 2)})));
+  search_tree->deduce(t1);
+
+  EXPECT_TRUE(search_tree->deduce());
+  EXPECT_FALSE(search_tree->is_singleton());
+  // A formula added to a search tree with several nodes is pending until we backtrack to root.
+  F upper = F::make_binary(F::make_avar(AVar(store->aty(), 2)), LEQ, F::make_z(1), store->aty());
+  IST::tell_type<standard_allocator> t2(standard_allocator{});
+  EXPECT_TRUE(search_tree->interpret_tell(upper, env, t2, diagnostics));
+  search_tree->deduce(t2);
+
+  IST::told_type told(standard_allocator{});
+  IST::path_type path(standard_allocator{});
+  EXPECT_TRUE(search_tree->steal(told, path));
+  EXPECT_EQ(told.sub_tells.size(), 2);
+  thief->restore(root, told, path);
+  EXPECT_EQ(thief_store->project(AVar(store->aty(), 0)), Itv(1, 2));
+  EXPECT_EQ(thief_store->project(AVar(store->aty(), 1)), Itv(1, 2));
+  EXPECT_EQ(thief_store->project(AVar(store->aty(), 2)), Itv(0, 1));
+  EXPECT_EQ(thief->split->num_strategies(), split->num_strategies());
+
+  // The formulas told are given to every thief, not only to the first one.
+  EXPECT_TRUE(search_tree->deduce());
+  IST::told_type told2(standard_allocator{});
+  IST::path_type path2(standard_allocator{});
+  EXPECT_TRUE(search_tree->steal(told2, path2));
+  EXPECT_EQ(told2.sub_tells.size(), 2);
+}